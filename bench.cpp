@@ -0,0 +1,221 @@
+#include <math.h>
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <condition_variable>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+#include <functional>
+#include <immintrin.h>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <queue>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "turn_budget.h"
+#include "wondev_book.h"
+
+// The bots are compiled as is, their main() become ww::main, dispatch::main and mm::main. Every header they include
+// must be included above, so that their own #include lines are no-ops inside the namespaces. Their #define are
+// global: the ones two bots share are dropped before the next bot redefines them.
+namespace ww {
+#include "wondev.cpp"
+}
+#undef FIRST_TURN_TIME
+#undef TURN_TIME
+#undef TURN_SAFETY
+#undef MAX_UNITS
+namespace dispatch {
+#include "dispatch.cpp"
+}
+namespace mm {
+#include "meanmax.cpp"
+}
+
+using namespace std;
+using namespace std::chrono;
+
+#define WARMUP (5)  // untimed samples before the measured ones
+#define SAMPLES (101)
+#define SEED (42)
+
+static volatile double sink;
+static string          filter;
+
+// Runs `kernel` over WARMUP then `samples` batches of `batch` calls, kernel(i) being call i of the batch, and prints
+// the distribution of the time per call over the batches. Kernels return a value folded into a checksum so that the
+// compiler keeps them.
+template <typename kernel_function>
+void measure(const string &name, int batch, int samples, kernel_function &&kernel) {
+  if (name.find(filter) == string::npos) return;
+  double         checksum = 0;
+  vector<double> nanos;
+  for (int s = 0; s < WARMUP + samples; s++) {
+    auto start = high_resolution_clock::now();
+    for (int i = 0; i < batch; i++) checksum += kernel(i);
+    duration<double, nano> elapsed = high_resolution_clock::now() - start;
+    if (s >= WARMUP) nanos.push_back(elapsed.count() / batch);
+  }
+  sort(nanos.begin(), nanos.end());
+  auto at = [&](double q) { return nanos[min(nanos.size() - 1, (size_t)(q * nanos.size()))]; };
+  cout << name << "," << batch << "," << samples << "," << fixed << setprecision(1) << nanos[0] << "," << at(0.1)
+       << "," << at(0.5) << "," << at(0.9) << "," << at(0.99) << defaultfloat << endl;
+  sink = checksum;
+}
+
+// Random 6x6 positions with 2 units a player: heights 0 to 3, some holes and domes, units on distinct cells
+vector<ww::State> wondevPositions(int count, uint64_t seed) {
+  dispatch::Rng rng(seed);
+  ww::size           = 6;
+  ww::unitsPerPlayer = 2;
+  ww::input_debug    = false;
+  vector<ww::State> positions(count);
+  for (auto &state : positions) {
+    for (int c = 0; c < ww::size * ww::size; c++) {
+      uint32_t draw          = rng.bounded(20);
+      state.board[c].height  = (draw == 0 ? -1 : draw == 1 ? 4 : draw % 4);
+      state.board[c].unitIdx = -1;
+    }
+    for (int u = 0; u < 2 * ww::unitsPerPlayer; u++) {
+      int c;
+      do {
+        c = rng.bounded(ww::size * ww::size);
+      } while (state.board[c].unitIdx != -1);
+      if (state.board[c].height < 0 || state.board[c].height > 3) state.board[c].height = 0;
+      state.board[c].unitIdx = u;
+      state.players[u]       = {(int8_t)(c % ww::size), (int8_t)(c / ww::size)};
+    }
+  }
+  return positions;
+}
+
+void wondevKernels(int samples) {
+  vector<ww::State>  positions = wondevPositions(256, SEED);
+  vector<ww::Action> actions;
+  measure("ww_computePossibleActions", 256, samples, [&](int i) {
+    positions[i].computePossibleActions(actions, i & 1);
+    return actions.size();
+  });
+
+  vector<pair<int, ww::Action> > moves;
+  for (int p = 0; p < (int)positions.size(); p++) {
+    positions[p].computePossibleActions(actions, true);
+    for (auto &action : actions) moves.push_back(make_pair(p, action));
+  }
+  measure("ww_applyAction+undoAction", moves.size(), samples, [&](int i) {
+    ww::State &state = positions[moves[i].first];
+    state.applyAction(moves[i].second);
+    int score = state.myScore;
+    state.undoAction(moves[i].second);
+    return score;
+  });
+  measure("ww_evaluateState", 256, samples, [&](int i) {
+    positions[i].evaluateState();
+    return positions[i].actionScore;
+  });
+}
+
+// A manifest of `nbBox` boxes over the default fleet, placed by LPT as the bot starts from
+void dispatchKernels(int samples, int nbBox) {
+  dispatch::seeder_s.seed(SEED);
+  dispatch::Rng rng(SEED);
+  FILE         *file      = tmpfile();
+  double        maxVolume = 2 * 0.8 * NB_TRUCK * dispatch::maxVolume_s / nbBox;
+  fprintf(file, "%d\n", nbBox);
+  for (int i = 0; i < nbBox; i++) fprintf(file, "%.2f %.5f\n", 1 + 49 * rng.uniform(), maxVolume * rng.uniform());
+  rewind(file);
+  dispatch::InputReader reader(file);
+  int                   boxCount = reader.readInt();
+  dispatch::State       train(boxCount, NB_TRUCK, high_resolution_clock::now());
+  dispatch::readInputs(train, reader);
+  fclose(file);
+  dispatch::init_s = dispatch::LPT_INIT;
+  dispatch::initState(train, false);
+
+  string suffix = "@" + to_string(nbBox);
+  vector<pair<int, int> > pairs(1024);
+  for (auto &p : pairs) p = make_pair(rng.bounded(NB_TRUCK), rng.bounded(NB_TRUCK));
+  measure("dp_swapBoxes+undoSwaps" + suffix, pairs.size(), samples, [&](int i) {
+    train.lastMoves.clear();
+    bool swapped = dispatch::swapBoxes(train, pairs[i].first, pairs[i].second);
+    dispatch::undoSwaps(train);
+    return swapped;
+  });
+  measure("dp_evaluate" + suffix, 64, samples, [&](int) { return dispatch::evaluate(train); });
+  vector<pair<int, int> > moves(1024);
+  for (auto &m : moves) m = make_pair(rng.bounded(nbBox), rng.bounded(NB_TRUCK));
+  measure("dp_moveBox" + suffix, moves.size(), samples, [&](int i) {
+    int from = train.boxPosition[moves[i].first];
+    train.moveBox(moves[i].first, moves[i].second);
+    train.moveBox(moves[i].first, from);
+    return from;
+  });
+}
+
+// A Mean Max turn: the 9 looters and `nbTanker` tankers spread over the map, as a simulation and as the input lines
+void meanmaxKernels(int samples, int nbTanker) {
+  mm::rngState = SEED;
+  mm::Simulation sim;
+  ostringstream  lines;
+  for (int i = 0; i < NB_LOOTER; i++) {
+    float px = 12000 * (mm::randFloat() - 0.5f), py = 12000 * (mm::randFloat() - 0.5f);
+    sim.setLooter(i, i, px, py, 0, 0);
+    lines << i << " " << i % 3 << " " << i / 3 << " 0.5 400 " << (int)px << " " << (int)py << " 0 0 -1 -1\n";
+  }
+  for (int t = 0; t < nbTanker; t++) {
+    float px = 12000 * (mm::randFloat() - 0.5f), py = 12000 * (mm::randFloat() - 0.5f);
+    sim.addTanker(100 + t, px, py, 0, 0, 1, 8, 600);
+    lines << 100 + t << " " << mm::TANKER << " -1 3.5 600 " << (int)px << " " << (int)py << " 0 0 1 8\n";
+  }
+  string suffix = "@" + to_string(NB_LOOTER + nbTanker);
+
+  mm::UnitTable table;
+  istringstream in(lines.str());
+  measure("mm_UnitTable::read" + suffix, 16, samples, [&](int) {
+    in.clear();
+    in.seekg(0);
+    table.read(in, NB_LOOTER + nbTanker);
+    return table.count;
+  });
+  measure("mm_Unit::distance" + suffix, table.count * table.count, samples, [&](int i) {
+    return table.units[i / table.count].distance(table.units[i % table.count]);
+  });
+
+  mm::SpatialIndex index;
+  measure("mm_SpatialIndex::build" + suffix, 16, samples, [&](int) {
+    index.build(sim);
+    return index.nbEntry;
+  });
+  vector<pair<float, float> > points(256);
+  for (auto &p : points) p = make_pair(12000 * (mm::randFloat() - 0.5f), 12000 * (mm::randFloat() - 0.5f));
+  int out[MAX_INDEXED];
+  measure("mm_SpatialIndex::nearest" + suffix, points.size(), samples, [&](int i) {
+    return index.nearest(points[i].first, points[i].second, 1 << mm::TANKER, 3, out);
+  });
+  measure("mm_SpatialIndex::radius" + suffix, points.size(), samples, [&](int i) {
+    return index.radius(points[i].first, points[i].second, 2000, 1 << mm::TANKER, out, MAX_INDEXED);
+  });
+}
+
+// Micro-benchmarks of the hot kernels of every bot, on inputs drawn from fixed seeds. Only the kernels whose name
+// contains the filter are run.
+int main(int argc, char const *argv[]) {
+  filter      = (argc > 1 ? argv[1] : "");
+  int samples = (argc > 2 ? atoi(argv[2]) : SAMPLES);
+  cerr.setstate(ios::failbit);  // the bots' logs
+  cout << "kernel,calls_per_sample,samples,min_ns,p10_ns,median_ns,p90_ns,p99_ns" << endl;
+  wondevKernels(samples);
+  for (int nbBox : {1000, 10000}) dispatchKernels(samples, nbBox);
+  for (int nbTanker : {6, 23}) meanmaxKernels(samples, nbTanker);
+  return 0;
+}
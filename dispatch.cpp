@@ -2,14 +2,23 @@
 #include <algorithm>
 #include <chrono>
 #include <climits>
+#include <condition_variable>
 #include <cmath>
+#include <cstdint>
+#include <cstdio>
 #include <ctime>
+#include <functional>
 #include <iostream>
+#include <mutex>
+#include <queue>
 #include <random>
 #include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 
+#include "turn_budget.h"
+
 #pragma GCC target("avx")
 #pragma GCC optimize("O3")
 #pragma GCC optimize("omit-frame-pointer")
@@ -20,8 +29,43 @@
 #define NB_TRUCK (100)
 #define MAX_T (100)
 #define SCORE_MULTIPLIER (20000)
-#define MAX_TIME (49.5)
+#define TIME_LIMIT (50)
+#define TIME_SAFETY (0.01)
 #define LOOP_TIME (16)
+#define MIN_LOOP_FRACTION (0.25)  // a restart is only worth it with this fraction of LOOP_TIME left
+#define PT_MIN_RATIO (0.001)
+#define PT_EPOCH_ITER (2000)
+#define PT_TARGET_SWAP (0.25)  // swap rate between neighbouring rungs the ladder adapts toward
+#define PT_ADAPT_EPOCHS (16)   // epochs between two adjustments of the ladder
+#define PT_ADAPT_GAIN (2.0)
+#define RANDOM_SWAP_TRIES (32)
+#define TIMER_SAMPLE_PERIOD (1e-4)
+#define TIMER_MAX_STRIDE (4096)
+#define LARGE_SCALE_BOXES_PER_TRUCK (200)
+#define INPUT_BUFFER_SIZE (1 << 16)
+#define SNAPSHOT_DUTY (9)
+#define KK_MAX_BOXES (4096)
+#define INIT_NOISE (0.05)
+#define WEIGHT_UNIT (0.01)  // weights are given in hundredths
+#define GAP_EPSILON (1e-9)
+#define EXACT_MAX_BOXES (40)        // manifests up to this size are first searched exactly
+#define EXACT_TIME_FRACTION (0.25)  // of the loop time, before falling back to annealing
+#define EXACT_CLOCK_PERIOD (1024)   // nodes of the exact search between two reads of the clock
+#define CHAIN_LENGTH (4)            // links of an ejection chain
+#define CHAIN_TRUCKS (4)            // random trucks tried as the next link of a chain
+#define CHAIN_SCAN (16)             // boxes of a truck looked at, sampled beyond that
+#define CHAIN_PERIOD (8)            // one neighbour in CHAIN_PERIOD is a compound move
+#define CALIBRATION_MOVES (200)       // moves sampled, and undone, to set the starting temperature
+#define CALIBRATION_ACCEPTANCE (0.5)  // of the mean uphill move at the starting temperature
+#define END_TEMPERATURE_RATIO (1e-3)  // of the starting temperature, at the end of a loop
+#define ADAPT_WINDOW (256)            // moves between two adjustments of the adaptive temperature
+#define ADAPT_FACTOR (1.1)
+#define ADAPT_START_ACCEPTANCE (0.5)  // acceptance rate aimed at, going geometrically from start to end
+#define ADAPT_END_ACCEPTANCE (0.005)
+#define STAGNATION_MOVES (200000)  // moves without a new best before reheating
+#define REHEAT_FRACTION (0.3)      // of the starting temperature, the least a reheat brings back
+#define REHEAT_DECAY (0.9999)      // per move, of the extra heat
+#define TELEMETRY_STRIDE (1000)    // moves between two telemetry rows
 
 using namespace std;
 using namespace std::chrono;
@@ -29,61 +73,500 @@ using namespace std::chrono;
 static double maxT_s            = MAX_T;
 static double scoreMultiplier_s = SCORE_MULTIPLIER;
 static double loopTime_s        = LOOP_TIME;
+static double maxTime_s         = TIME_LIMIT;
+static int    nbTruck_s         = NB_TRUCK;
+static double maxVolume_s       = MAX_VOLUME;
+static int    largeScale_s      = -1;  // -1 => decided from the number of boxes per truck
+static int    exact_s           = -1;  // -1 => decided from the number of boxes
+
+enum initType { BASIC_INIT, RAND_INIT, LPT_INIT, KK_INIT, INIT_TYPE_MAX };
+static const vector<string> init2str = {"basic", "rand", "lpt", "kk"};
+static int                  init_s   = BASIC_INIT;
+enum coolingType { LINEAR_COOLING, EXP_COOLING, LUNDY_MEES_COOLING, ADAPTIVE_COOLING, COOLING_TYPE_MAX };
+static const vector<string> cooling2str = {"linear", "exp", "lundy", "adaptive"};
+static int                  cooling_s   = ADAPTIVE_COOLING;
+static bool                 calibrate_s = true;  // starting temperature from sampled moves, unless Tmax is given
+static int    nbReplica_s       = 0;  // 0 => restarts of simulated annealing, otherwise parallel tempering
+static bool   randomMoves_s     = false;  // random neighbour instead of the best swap between two trucks
+static bool   chainMoves_s      = true;   // ejection chains and 2-for-1 swaps among the neighbours
+static double gapTolerance_s    = 0;      // stop once the spread is provably this close to optimal, < 0 => never
+static double spreadBound_s     = 0;      // lower bound of the spread of any solution of the manifest
+
+// xoshiro256** seeded through splitmix64: a few cycles per draw and reproducible from a single seed
+struct Rng {
+  uint64_t s[4];
+  Rng(uint64_t seed = 0) { this->seed(seed); }
+  void seed(uint64_t seed) {
+    for (auto &word : s) {
+      uint64_t z = (seed += 0x9e3779b97f4a7c15ULL);
+      z          = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+      z          = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+      word       = z ^ (z >> 31);
+    }
+  }
+  static uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+  uint64_t        next() {
+    uint64_t result = rotl(s[1] * 5, 7) * 9;
+    uint64_t t      = s[1] << 17;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotl(s[3], 45);
+    return result;
+  }
+  // uniform integer in [0, n), multiply-shift instead of a modulo
+  uint32_t bounded(uint32_t n) { return ((next() >> 32) * n) >> 32; }
+  // uniform real in [0, 1)
+  double uniform() { return (next() >> 11) * (1.0 / 9007199254740992.0); }
+};
+
+static uint64_t seed_s = random_device{}();
+static Rng      seeder_s;  // hands out the seeds of every other generator, in a reproducible order
+
+uint64_t nextSeed() { return seeder_s.next(); }
+
+// Rows of run, elapsed seconds, move, current energy, best energy, temperature and acceptance rate over the last
+// `stride` moves, written every `stride` moves when a file is open. Runs are numbered so that restarts can be told
+// apart.
+struct Telemetry {
+  FILE                             *file;
+  time_point<high_resolution_clock> start;
+  long long                         stride, moves;
+  int                               run, accepted;
+  Telemetry() : file(NULL), stride(1), moves(0), run(0), accepted(0) {}
+  void open(const char *path, long long s, time_point<high_resolution_clock> t) {
+    file   = fopen(path, "w");
+    stride = max(1LL, s);
+    start  = t;
+    if (file) fprintf(file, "run,time_s,move,energy,best,temperature,acceptance\n");
+  }
+  void begin() {
+    run++;
+    moves = accepted = 0;
+  }
+  void operator()(double energy, double best, double temperature, bool wasAccepted) {
+    if (file == NULL) return;
+    accepted += wasAccepted;
+    if (++moves % stride != 0) return;
+    duration<double> elapsed = high_resolution_clock::now() - start;
+    fprintf(file, "%d,%.6f,%lld,%.6g,%.6g,%.6g,%.4f\n", run, elapsed.count(), moves, energy, best, temperature,
+            (double)accepted / stride);
+    accepted = 0;
+  }
+  void close() {
+    if (file) fclose(file);
+    file = NULL;
+  }
+};
+
+struct NoTelemetry {
+  void operator()(double, double, double, bool) {}
+};
+
+static Telemetry telemetry_s;
+
+// Mean energy increase of the uphill moves among CALIBRATION_MOVES moves from a state, each undone, 0 if none
+template <typename state, typename energy_function, typename next_function, typename previous_function>
+double meanUphill(state             &s,
+                  energy_function   &&energyFunction,
+                  next_function     &&nextFunction,
+                  previous_function &&previousFunction) {
+  double energy   = energyFunction(s);
+  double uphill   = 0;
+  int    nbUphill = 0;
+  for (int i = 0; i < CALIBRATION_MOVES; i++) {
+    nextFunction(s);
+    double delta_e = energyFunction(s) - energy;
+    previousFunction(s);
+    if (delta_e > 0) {
+      uphill += delta_e;
+      nbUphill++;
+    }
+  }
+  return nbUphill > 0 ? uphill / nbUphill : 0;
+}
 
-// To find a state with lower energy according to the given condition
+// To find a state with lower energy according to the given condition.
+// The schedule is a policy type: calibrate(mean uphill delta) once, temperature(c) with c going from 1 down to 0, and
+// observe(accepted, new best) after every move. Each schedule is its own instantiation, so none of it is an indirect
+// call in the loop; the same goes for the telemetry, which sees every move.
 template <typename state,
           typename count,
           typename energy_function,
-          typename temperature_function,
+          typename schedule,
           typename next_function,
           typename previous_function,
-          typename counter_function>
-state simulated_annealing(state                 &state_old,
-                          count                 &c,
-                          energy_function      &&energyFunction,
-                          temperature_function &&temperatureFunction,
-                          next_function        &&nextFunction,
-                          previous_function    &&previousFunction,
-                          counter_function     &&updateCounter) {
-  random_device rd;
-  mt19937_64    g(rd());
+          typename counter_function,
+          typename telemetry = NoTelemetry>
+state simulated_annealing(state              &state_old,
+                          count              &c,
+                          energy_function   &&energyFunction,
+                          schedule          &&cooling,
+                          next_function     &&nextFunction,
+                          previous_function &&previousFunction,
+                          counter_function  &&updateCounter,
+                          telemetry         &&trace = telemetry()) {
+  Rng g(nextSeed());
 
   auto energy_old = energyFunction(state_old);
+  if (calibrate_s) cooling.calibrate(meanUphill(state_old, energyFunction, nextFunction, previousFunction));
 
-  state state_best  = state_old;
-  auto  energy_best = energy_old;
-
-  uniform_real_distribution<decltype(energy_old)> rf(0, 1);
+  state  state_best  = state_old;
+  auto   energy_best = energy_old;
+  bool   atBest      = true;  // state_old is the best state, which is only copied when the walk leaves it
+  double t           = 0;
+  auto   snapshotEnd = high_resolution_clock::now();
+  duration<double> snapshotCost(0);
 
   for (; c > 0; updateCounter(state_old, c)) {
     nextFunction(state_old);
     auto energy_new = energyFunction(state_old);
+    bool improved   = (energy_new < energy_best);
+    bool accepted   = improved;
 
-    if (energy_new < energy_best) {
-      state_best  = state_old;
+    if (improved) {
       energy_best = energy_new;
       energy_old  = move(energy_new);
-      continue;
+      atBest      = true;
+    } else {
+      t            = cooling.temperature(c);
+      auto delta_e = energy_new - energy_old;
+      // exp(-10.0) being a very small number, worse moves are not even drawn for
+      accepted = (delta_e <= 10.0 * t && (delta_e < 0.0 || exp(-delta_e / t) > g.uniform()));
+      if (!accepted) {
+        previousFunction(state_old);
+      } else if (atBest) {
+        // snapshot the best state before leaving it, at the cost of giving up this move. On huge states the walk
+        // stays on its best state for SNAPSHOT_DUTY times the cost of the previous copy, so copies stay a small share.
+        previousFunction(state_old);
+        accepted = false;
+        auto now = high_resolution_clock::now();
+        if (now - snapshotEnd >= SNAPSHOT_DUTY * snapshotCost) {
+          state_best   = state_old;
+          snapshotEnd  = high_resolution_clock::now();
+          snapshotCost = snapshotEnd - now;
+          atBest       = false;
+        }
+      } else {
+        energy_old = move(energy_new);
+      }
     }
+    cooling.observe(accepted, improved);
+    trace(energy_old, energy_best, t, accepted);
+  }
+  if (atBest) state_best = state_old;
+  return (state_best);
+}
 
-    auto t       = temperatureFunction(c);
-    auto delta_e = energy_new - energy_old;
+// Common part of the schedules: the starting temperature, Tmax unless calibrated so that the mean uphill move is
+// accepted with CALIBRATION_ACCEPTANCE, and the reheating. After STAGNATION_MOVES moves without a new best, the temperature goes
+// back up to REHEAT_FRACTION of the starting one at least, the extra heat fading by REHEAT_DECAY a move.
+struct Cooling {
+  double    t0, base, reheat;
+  long long sinceBest;
+  int       reheats;
+  Cooling() : t0(maxT_s), base(maxT_s), reheat(1), sinceBest(0), reheats(0) {}
+  void calibrate(double meanUphill) {
+    if (meanUphill > 0) t0 = -meanUphill / log(CALIBRATION_ACCEPTANCE);
+  }
+  double heat(double temperature) {
+    base = temperature;
+    return base * reheat;
+  }
+  void observe(bool, bool improved) {
+    reheat = 1 + (reheat - 1) * REHEAT_DECAY;
+    if (improved) {
+      sinceBest = 0;
+    } else if (++sinceBest >= STAGNATION_MOVES) {
+      sinceBest = 0;
+      reheat    = max(reheat, REHEAT_FRACTION * t0 / max(base, 1e-12));
+      reheats++;
+    }
+  }
+};
+
+struct LinearCooling : Cooling {
+  double temperature(long double c) { return heat(c * t0); }
+};
 
-    if (delta_e > 10.0 * t) {
-      previousFunction(state_old);
-      continue;  // as std::exp(-10.0) is a very small number
+struct ExponentialCooling : Cooling {
+  double temperature(long double c) { return heat(t0 * pow(END_TEMPERATURE_RATIO, 1 - (double)c)); }
+};
+
+// Lundy-Mees, T <- T / (1 + beta T) every move, in closed form over the fraction of the loop elapsed, beta being set
+// so that the loop ends at END_TEMPERATURE_RATIO of the starting temperature
+struct LundyMeesCooling : Cooling {
+  double temperature(long double c) { return heat(t0 / (1 + (1 / END_TEMPERATURE_RATIO - 1) * (1 - (double)c))); }
+};
+
+// The temperature follows the acceptance rate: every ADAPT_WINDOW moves it goes down by ADAPT_FACTOR when more moves
+// than aimed at were accepted, up otherwise, the rate aimed at going from ADAPT_START_ACCEPTANCE to
+// ADAPT_END_ACCEPTANCE over the loop
+struct AdaptiveCooling : Cooling {
+  double      t;
+  long double c;
+  int         moves, accepted;
+  AdaptiveCooling() : t(maxT_s), c(1), moves(0), accepted(0) {}
+  void calibrate(double meanUphill) {
+    Cooling::calibrate(meanUphill);
+    t = t0;
+  }
+  double temperature(long double k) {
+    c = k;
+    return heat(t);
+  }
+  void observe(bool wasAccepted, bool improved) {
+    Cooling::observe(wasAccepted, improved);
+    accepted += wasAccepted;
+    if (++moves < ADAPT_WINDOW) return;
+    double aim = ADAPT_END_ACCEPTANCE * pow(ADAPT_START_ACCEPTANCE / ADAPT_END_ACCEPTANCE, (double)c);
+    t          = ((double)accepted / moves > aim ? t / ADAPT_FACTOR : t * ADAPT_FACTOR);
+    moves = accepted = 0;
+  }
+};
+
+struct RungStats {
+  long long moves, accepted, swapTries, swaps;
+  RungStats() : moves(0), accepted(0), swapTries(0), swaps(0) {}
+};
+
+// Replica exchange: replica r runs Metropolis steps at temperatures[r] in its own thread for an epoch,
+// then neighbouring rungs try to exchange their states (even pairs and odd pairs alternately). The threads live for the
+// whole run, so short epochs do not pay for thread creation.
+// The ladder adapts: every PT_ADAPT_EPOCHS epochs the log gap between two neighbouring rungs shrinks when they swapped
+// less often than PT_TARGET_SWAP and widens otherwise. The coldest rung stays put and the hottest never goes above
+// its starting temperature.
+template <typename state,
+          typename energy_function,
+          typename next_function,
+          typename previous_function,
+          typename stop_function>
+state parallel_tempering(vector<state>          &replicas,
+                         vector<double>         &temperatures,
+                         vector<RungStats>      &stats,
+                         energy_function      &&energyFunction,
+                         next_function        &&nextFunction,
+                         previous_function    &&previousFunction,
+                         stop_function        &&stopFunction) {
+  int nbRung = replicas.size();
+  typedef decltype(energyFunction(replicas[0])) energy;
+
+  vector<int>    rungReplica(nbRung);  // index of the replica currently sitting on each rung
+  vector<energy> energies(nbRung);
+  vector<state>  bests = replicas;
+  vector<energy> bestEnergies(nbRung);
+  for (int r = 0; r < nbRung; r++) {
+    rungReplica[r]  = r;
+    energies[r]     = energyFunction(replicas[r]);
+    bestEnergies[r] = energies[r];
+  }
+  stats.assign(nbRung, RungStats());
+  double         maxLogSpan = log(temperatures.back() / temperatures[0]);
+  vector<double> gaps(max(nbRung - 1, 0));  // log(temperatures[r + 1] / temperatures[r])
+  vector<int>    windowTries(gaps.size()), windowSwaps(gaps.size());
+  for (int r = 0; r + 1 < nbRung; r++) {
+    gaps[r] = log(temperatures[r + 1] / temperatures[r]);
+  }
+  vector<Rng> rngs;  // one stream per rung, so results do not depend on thread scheduling
+  for (int r = 0; r < nbRung; r++) {
+    rngs.push_back(Rng(nextSeed()));
+  }
+
+  auto runRung = [&](int rung) {
+    Rng       &g     = rngs[rung];
+    int        r     = rungReplica[rung];
+    double     t     = temperatures[rung];
+    state     &s     = replicas[r];
+    energy     e_old = energies[r];
+    RungStats &st    = stats[rung];
+
+    for (int i = 0; i < PT_EPOCH_ITER; i++) {
+      nextFunction(s);
+      auto delta_e = energyFunction(s) - e_old;
+      st.moves++;
+      if (delta_e <= 0.0 || (delta_e < 10.0 * t && exp(-delta_e / t) > g.uniform())) {
+        e_old += delta_e;
+        st.accepted++;
+        if (e_old < bestEnergies[r]) {
+          bestEnergies[r] = e_old;
+          bests[r]        = s;
+        }
+      } else {
+        previousFunction(s);
+      }
     }
+    energies[r] = e_old;
+  };
 
-    if (delta_e < 0.0 || exp(-delta_e / t) > rf(g)) {
-      energy_old = move(energy_new);
-    } else {
-      previousFunction(state_old);
+  // one worker per rung above the first for the whole run, the calling thread running the first rung: each epoch
+  // is handed out by bumping `epochs`, and the last worker done wakes the calling thread for the exchanges
+  mutex              lock;
+  condition_variable wake, done;
+  int                epochs = 0, running = 0;
+  bool               quit   = false;
+  vector<thread>     workers;
+  for (int rung = 1; rung < nbRung; rung++) {
+    workers.emplace_back([&, rung]() {
+      for (int seen = 0;; seen++) {
+        {
+          unique_lock<mutex> guard(lock);
+          wake.wait(guard, [&]() { return quit || epochs > seen; });
+          if (quit) return;
+        }
+        runRung(rung);
+        lock_guard<mutex> guard(lock);
+        if (--running == 0) done.notify_one();
+      }
+    });
+  }
+
+  Rng g(nextSeed());
+  for (int epoch = 0; !stopFunction(); epoch++) {
+    {
+      lock_guard<mutex> guard(lock);
+      epochs++;
+      running = nbRung - 1;
+    }
+    wake.notify_all();
+    runRung(0);
+    {
+      unique_lock<mutex> guard(lock);
+      done.wait(guard, [&]() { return running == 0; });
+    }
+
+    for (int rung = epoch % 2; rung + 1 < nbRung; rung += 2) {
+      int    r1  = rungReplica[rung];
+      int    r2  = rungReplica[rung + 1];
+      double arg = (energies[r1] - energies[r2]) * (1.0 / temperatures[rung] - 1.0 / temperatures[rung + 1]);
+      stats[rung].swapTries++;
+      windowTries[rung]++;
+      if (arg >= 0.0 || exp(arg) > g.uniform()) {
+        swap(rungReplica[rung], rungReplica[rung + 1]);
+        stats[rung].swaps++;
+        windowSwaps[rung]++;
+      }
+    }
+
+    if ((epoch + 1) % PT_ADAPT_EPOCHS == 0 && nbRung > 1) {
+      double span = 0.0;
+      for (int r = 0; r + 1 < nbRung; r++) {
+        gaps[r] *= exp(PT_ADAPT_GAIN * ((double)windowSwaps[r] / windowTries[r] - PT_TARGET_SWAP));
+        span += gaps[r];
+        windowTries[r] = windowSwaps[r] = 0;
+      }
+      double scale = span > maxLogSpan ? maxLogSpan / span : 1.0;
+      for (int r = 0; r + 1 < nbRung; r++) {
+        temperatures[r + 1] = temperatures[r] * exp(gaps[r] *= scale);
+      }
     }
   }
-  return (state_best);
+  {
+    lock_guard<mutex> guard(lock);
+    quit = true;
+  }
+  wake.notify_all();
+  for (auto &worker : workers) {
+    worker.join();
+  }
+
+  int best = min_element(bestEnergies.begin(), bestEnergies.end()) - bestEnergies.begin();
+  return (bests[best]);
 }
 
-auto tf = [](long double k) { return k * maxT_s; };
+// Fraction of a loop already elapsed. The clock is only read every `stride` ticks and the time in between is
+// extrapolated from the last measured cost per tick; the stride adapts so that two reads stay about
+// TIMER_SAMPLE_PERIOD apart, which bounds how late the end of the loop can be noticed.
+struct LoopTimer {
+  time_point<high_resolution_clock> start;
+  double                            loopTime;
+  double                            elapsed;     // seconds, measured or extrapolated
+  double                            lastSample;  // seconds, measured
+  double                            tickTime;    // seconds per tick, measured between the last two reads
+  unsigned                          stride, countdown;
+
+  LoopTimer(time_point<high_resolution_clock> s, double l) { reset(s, l); }
+  void reset(time_point<high_resolution_clock> s, double l) {
+    start      = s;
+    loopTime   = l;
+    elapsed    = 0;
+    lastSample = 0;
+    tickTime   = 0;
+    stride     = 1;
+    countdown  = 1;
+  }
+  // on a read forced before the countdown ran out, fewer than `stride` ticks went by since the last one
+  double sample() {
+    duration<double> now = high_resolution_clock::now() - start;
+    tickTime             = (now.count() - lastSample) / max(1u, stride - countdown);
+    lastSample = elapsed = now.count();
+    stride               = tickTime > 0 ? max(1.0, min((double)TIMER_MAX_STRIDE, TIMER_SAMPLE_PERIOD / tickTime)) : 1;
+    countdown            = stride;
+    return elapsed / loopTime;
+  }
+  double tick() {
+    if (--countdown == 0) return sample();
+    elapsed += tickTime;
+    if (elapsed >= loopTime) return sample();  // never stop on an extrapolation
+    return elapsed / loopTime;
+  }
+};
+
+// Buffered reader for the box list: numbers are parsed straight from fread() chunks, as going through iostream
+// dominates the start-up time on manifests with hundreds of thousands of boxes
+struct InputReader {
+  FILE        *file;
+  vector<char> buffer;
+  size_t       pos, len;
+
+  InputReader(FILE *f) : file(f), buffer(INPUT_BUFFER_SIZE), pos(0), len(0) {}
+  int peek() {
+    if (pos == len) {
+      pos = 0;
+      len = fread(buffer.data(), 1, buffer.size(), file);
+      if (len == 0) return EOF;
+    }
+    return buffer[pos];
+  }
+  void skipSpaces() {
+    while (peek() != EOF && isspace(buffer[pos])) pos++;
+  }
+  double readDouble() {
+    skipSpaces();
+    bool negative = (peek() == '-');
+    if (negative || peek() == '+') pos++;
+    uint64_t mantissa = 0;
+    int      exponent = 0, digits = 0;
+    for (; peek() != EOF && isdigit(buffer[pos]); pos++) {
+      if (digits++ < 18) {
+        mantissa = 10 * mantissa + (buffer[pos] - '0');
+      } else {
+        exponent++;
+      }
+    }
+    if (peek() == '.') {
+      for (pos++; peek() != EOF && isdigit(buffer[pos]); pos++) {
+        if (digits++ < 18) {
+          mantissa = 10 * mantissa + (buffer[pos] - '0');
+          exponent--;
+        }
+      }
+    }
+    if (peek() == 'e' || peek() == 'E') {
+      pos++;
+      bool negativeExponent = (peek() == '-');
+      if (negativeExponent || peek() == '+') pos++;
+      int e = 0;
+      for (; peek() != EOF && isdigit(buffer[pos]); pos++) e = 10 * e + (buffer[pos] - '0');
+      exponent += negativeExponent ? -e : e;
+    }
+    // dividing by an exact power of ten keeps short decimals such as 7.58 correctly rounded
+    double value = exponent < 0 ? mantissa / pow(10.0, -exponent) : mantissa * pow(10.0, exponent);
+    return negative ? -value : value;
+  }
+  long readInt() { return lround(readDouble()); }
+};
 
 struct Box {
   int    index;
@@ -112,16 +595,16 @@ struct Truck {
     weight += box.weight;
     boxes.push_back(box.index);
   }
-  void removeBox(Box &box) {
-    vector<int>::iterator position = find(boxes.begin(), boxes.end(), box.index);
-    if (position != boxes.end()) {
-      boxes.erase(position);
-      volume -= box.volume;
-      weight -= box.weight;
-    }
+  // the last box takes the freed slot, returns its index or -1 if the removed box was the last one
+  int removeBox(Box &box, int slot) {
+    boxes[slot] = boxes.back();
+    boxes.pop_back();
+    volume -= box.volume;
+    weight -= box.weight;
+    return slot < (int)boxes.size() ? boxes[slot] : -1;
   }
-  bool checkLimits(int avg, int sd) { return (volume <= MAX_VOLUME) && (weight <= avg + sd); }
-  bool checkNewBox(Box &box) { return (volume + box.volume <= MAX_VOLUME); }
+  bool checkLimits(int avg, int sd) { return (volume <= maxVolume_s) && (weight <= avg + sd); }
+  bool checkNewBox(Box &box) { return (volume + box.volume <= maxVolume_s); }
 };
 
 struct State {
@@ -129,24 +612,27 @@ struct State {
   int                               nbBox;
   int                               nbTruck;
   double                            targetWeight;
-  time_point<high_resolution_clock> start;
+  LoopTimer                         timer;
   vector<Truck>                     trucks;
   vector<int>                       boxPosition;
+  vector<int>                       boxSlot;  // index of the box in its truck's list
   int                               minIndex, maxIndex;
   vector<pair<int, int> > lastMoves;  // box index + origin truck index
+  Rng                     rng;        // neighbour generation, each replica owns its stream
   State(int b, int t, time_point<high_resolution_clock> s)
-      : nbBox(b), nbTruck(t), targetWeight(0), start(s), minIndex(-1), maxIndex(-1) {}
+      : nbBox(b), nbTruck(t), targetWeight(0), timer(s, loopTime_s), minIndex(-1), maxIndex(-1), rng(nextSeed()) {}
   void addBox(Box &b) { boxes.push_back(b); }
   void insertBox(int boxIndex, int truckDest) {
     Box &box = boxes[boxIndex];
+    boxSlot[boxIndex] = trucks[truckDest].boxes.size();
     trucks[truckDest].insertBox(box);
     boxPosition[boxIndex] = truckDest;
   }
   void moveBox(int boxIndex, int truckDest) {
-    Box &box = boxes[boxIndex];
-    trucks[boxPosition[boxIndex]].removeBox(box);
-    trucks[truckDest].insertBox(box);
-    boxPosition[boxIndex] = truckDest;
+    Box &box   = boxes[boxIndex];
+    int  moved = trucks[boxPosition[boxIndex]].removeBox(box, boxSlot[boxIndex]);
+    if (moved != -1) boxSlot[moved] = boxSlot[boxIndex];
+    insertBox(boxIndex, truckDest);
   }
   void reset() {
     for (auto &truck : trucks) {
@@ -158,7 +644,7 @@ struct State {
     minIndex = -1;
     maxIndex = -1;
     lastMoves.clear();
-    start = high_resolution_clock::now();
+    timer.reset(high_resolution_clock::now(), loopTime_s);
   }
 };
 
@@ -183,7 +669,7 @@ double evaluate(State &train) {
       train.maxIndex = truck.index;
     }
   }
-  score /= NB_TRUCK;
+  score /= train.nbTruck;
   return scoreMultiplier_s * (maxWeight - minWeight + score);
 }
 
@@ -197,7 +683,7 @@ bool swapBoxes(State &train, int t1Index, int t2Index) {
 
   if (t1.weight >= t2.weight) {
     for (auto &t1BoxIndex : t1.boxes) {
-      if (t2.volume + train.boxes[t1BoxIndex].volume > MAX_VOLUME) continue;
+      if (t2.volume + train.boxes[t1BoxIndex].volume > maxVolume_s) continue;
       double score = fabs(t1.weight - train.boxes[t1BoxIndex].weight - train.targetWeight) +
                      fabs(t2.weight + train.boxes[t1BoxIndex].weight - train.targetWeight);
       if (score < best_score) {
@@ -207,7 +693,7 @@ bool swapBoxes(State &train, int t1Index, int t2Index) {
     }
   } else {
     for (auto &t2BoxIndex : t2.boxes) {
-      if (t1.volume + train.boxes[t2BoxIndex].volume > MAX_VOLUME) continue;
+      if (t1.volume + train.boxes[t2BoxIndex].volume > maxVolume_s) continue;
       double score = fabs(t1.weight + train.boxes[t2BoxIndex].weight - train.targetWeight) +
                      fabs(t2.weight - train.boxes[t2BoxIndex].weight - train.targetWeight);
       if (score < best_score) {
@@ -218,8 +704,8 @@ bool swapBoxes(State &train, int t1Index, int t2Index) {
   }
   for (auto &t1BoxIndex : t1.boxes) {
     for (auto &t2BoxIndex : t2.boxes) {
-      if (t1.volume - train.boxes[t1BoxIndex].volume + train.boxes[t2BoxIndex].volume > MAX_VOLUME ||
-          t2.volume - train.boxes[t2BoxIndex].volume + train.boxes[t1BoxIndex].volume > MAX_VOLUME)
+      if (t1.volume - train.boxes[t1BoxIndex].volume + train.boxes[t2BoxIndex].volume > maxVolume_s ||
+          t2.volume - train.boxes[t2BoxIndex].volume + train.boxes[t1BoxIndex].volume > maxVolume_s)
         continue;
       double score =
           fabs(t1.weight - train.boxes[t1BoxIndex].weight + train.boxes[t2BoxIndex].weight - train.targetWeight) +
@@ -243,71 +729,249 @@ bool swapBoxes(State &train, int t1Index, int t2Index) {
   return true;
 }
 
+// Pick a random valid move between two trucks without enumerating them: half of the draws move a box from the
+// heavier truck to the lighter one, the other half swap a pair of boxes (counting candidates uniformly would make
+// single moves vanishingly rare with thousands of boxes per truck). Infeasible draws are rejected and redrawn,
+// RANDOM_SWAP_TRIES times at most.
 bool swapRandomBoxes(State &train, int t1Index, int t2Index) {
   Truck &t1 = train.trucks[t1Index];
   Truck &t2 = train.trucks[t2Index];
-  vector<vector<pair<int, int> > > swapList;
+  if (t1.weight < t2.weight) return swapRandomBoxes(train, t2Index, t1Index);
 
-  if (t1.weight >= t2.weight) {
-    for (auto &t1BoxIndex : t1.boxes) {
-      if (t2.volume + train.boxes[t1BoxIndex].volume > MAX_VOLUME) continue;
-      vector<pair<int, int> > v;
-      v.push_back(pair<int, int>(t1BoxIndex, t2Index));
-      swapList.push_back(v);
+  uint32_t n1 = t1.boxes.size();
+  uint32_t n2 = t2.boxes.size();
+  if (n1 == 0) return false;  // cannot do better...
+  for (int i = 0; i < RANDOM_SWAP_TRIES; i++) {
+    int t1BoxIndex = t1.boxes[train.rng.bounded(n1)];
+    if (n2 == 0 || (train.rng.next() & 1)) {
+      if (t2.volume + train.boxes[t1BoxIndex].volume > maxVolume_s) continue;
+      train.moveBox(t1BoxIndex, t2Index);
+      train.lastMoves.push_back(pair<int, int>(t1BoxIndex, t1Index));
+      return true;
     }
-  } else {
-    for (auto &t2BoxIndex : t2.boxes) {
-      if (t1.volume + train.boxes[t2BoxIndex].volume > MAX_VOLUME) continue;
-      vector<pair<int, int> > v;
-      v.push_back(pair<int, int>(t2BoxIndex, t1Index));
-      swapList.push_back(v);
+    int t2BoxIndex = t2.boxes[train.rng.bounded(n2)];
+    if (t1.volume - train.boxes[t1BoxIndex].volume + train.boxes[t2BoxIndex].volume > maxVolume_s ||
+        t2.volume - train.boxes[t2BoxIndex].volume + train.boxes[t1BoxIndex].volume > maxVolume_s)
+      continue;
+    train.moveBox(t1BoxIndex, t2Index);
+    train.moveBox(t2BoxIndex, t1Index);
+    train.lastMoves.push_back(pair<int, int>(t1BoxIndex, t1Index));
+    train.lastMoves.push_back(pair<int, int>(t2BoxIndex, t2Index));
+    return true;
+  }
+  return false;
+}
+
+void undoSwaps(State &train) {
+  for (unsigned i = train.lastMoves.size(); i-- > 0;) {
+    auto &swap = train.lastMoves[i];
+    train.moveBox(swap.first, swap.second);
+  }
+}
+
+// Boxes of a truck to look at: all of them, or CHAIN_SCAN drawn at random
+void scanBoxes(State &train, int truckIndex, vector<int> &boxIndexes) {
+  vector<int> &boxes = train.trucks[truckIndex].boxes;
+  if (boxes.size() <= CHAIN_SCAN) {
+    boxIndexes = boxes;
+    return;
+  }
+  boxIndexes.clear();
+  for (int i = 0; i < CHAIN_SCAN; i++) boxIndexes.push_back(boxes[train.rng.bounded(boxes.size())]);
+}
+
+double deviation(State &train, int truckIndex, double delta) {
+  return fabs(train.trucks[truckIndex].weight + delta - train.targetWeight);
+}
+
+void transferBox(State &train, int boxIndex, int truckDest) {
+  train.lastMoves.push_back(pair<int, int>(boxIndex, train.boxPosition[boxIndex]));
+  train.moveBox(boxIndex, truckDest);
+}
+
+// Two boxes of t1 against one of t2, the best of the scanned boxes if it brings both trucks closer to the target
+bool swapTwoForOne(State &train, int t1Index, int t2Index) {
+  Truck      &t1 = train.trucks[t1Index];
+  Truck      &t2 = train.trucks[t2Index];
+  vector<int> from1, from2;
+  scanBoxes(train, t1Index, from1);
+  scanBoxes(train, t2Index, from2);
+  double best_score = deviation(train, t1Index, 0) + deviation(train, t2Index, 0) - GAP_EPSILON;
+  int    best[3]    = {-1, -1, -1};
+  for (size_t i = 0; i < from1.size(); i++) {
+    Box &a = train.boxes[from1[i]];
+    for (size_t j = i + 1; j < from1.size(); j++) {
+      Box &b = train.boxes[from1[j]];
+      if (a.index == b.index) continue;
+      for (auto c : from2) {
+        double weight = a.weight + b.weight - train.boxes[c].weight;
+        double volume = a.volume + b.volume - train.boxes[c].volume;
+        if (t2.volume + volume > maxVolume_s || t1.volume - volume > maxVolume_s) continue;
+        double score = deviation(train, t1Index, -weight) + deviation(train, t2Index, weight);
+        if (score < best_score) {
+          best_score = score;
+          best[0]    = a.index;
+          best[1]    = b.index;
+          best[2]    = c;
+        }
+      }
     }
   }
-  for (auto &t1BoxIndex : t1.boxes) {
-    for (auto &t2BoxIndex : t2.boxes) {
-      if (t1.volume - train.boxes[t1BoxIndex].volume + train.boxes[t2BoxIndex].volume > MAX_VOLUME ||
-          t2.volume - train.boxes[t2BoxIndex].volume + train.boxes[t1BoxIndex].volume > MAX_VOLUME)
-        continue;
-      vector<pair<int, int> > v;
-      v.push_back(pair<int, int>(t1BoxIndex, t2Index));
-      v.push_back(pair<int, int>(t2BoxIndex, t1Index));
-      swapList.push_back(v);
+  if (best[0] == -1) return false;
+  transferBox(train, best[0], t2Index);
+  transferBox(train, best[1], t2Index);
+  transferBox(train, best[2], t1Index);
+  return true;
+}
+
+// Ejection chain from the heaviest truck: each link moves the box that best brings the two trucks it joins closer to
+// the target, first to a random truck, then to the lightest truck or back to the heaviest, which ends the chain, or to
+// another random truck not yet in the chain. The links past the best total gain are undone, so the chain spans three
+// trucks at least and only stays if the trucks it went through are closer to the target on the whole.
+bool ejectionChain(State &train, int heavy, int light) {
+  double      gain = 0, best_gain = GAP_EPSILON;
+  size_t      best_length = 0;
+  int         from        = heavy;
+  vector<int> boxIndexes, destinations, visited(1, heavy);
+  for (int link = 0; link < CHAIN_LENGTH; link++) {
+    destinations.clear();
+    if (link > 0) {
+      destinations.push_back(light);
+      if (link > 1) destinations.push_back(heavy);
+    }
+    for (int t = 0; t < CHAIN_TRUCKS; t++) {
+      int dest = train.rng.bounded(train.nbTruck);
+      if (find(visited.begin(), visited.end(), dest) == visited.end()) destinations.push_back(dest);
+    }
+    scanBoxes(train, from, boxIndexes);
+    double best_delta = INT_MAX;
+    int    best_box = -1, best_dest = -1;
+    for (auto dest : destinations) {
+      if (dest == from || (link == 0 && dest == light)) continue;
+      double current = deviation(train, from, 0) + deviation(train, dest, 0);
+      for (auto boxIndex : boxIndexes) {
+        Box &box = train.boxes[boxIndex];
+        if (train.trucks[dest].volume + box.volume > maxVolume_s) continue;
+        double delta = deviation(train, from, -box.weight) + deviation(train, dest, box.weight) - current;
+        if (delta < best_delta) {
+          best_delta = delta;
+          best_box   = boxIndex;
+          best_dest  = dest;
+        }
+      }
     }
+    if (best_box == -1) break;
+    transferBox(train, best_box, best_dest);
+    gain -= best_delta;
+    if (link > 0 && gain > best_gain) {
+      best_gain   = gain;
+      best_length = train.lastMoves.size();
+    }
+    if (best_dest == light || best_dest == heavy) break;
+    visited.push_back(best_dest);
+    from = best_dest;
   }
-  if (swapList.size() == 0) return false;  // cannot do better...
-  int i = rand() % swapList.size();
-  for (auto &swap : swapList[i]) {
-    train.moveBox(swap.first, swap.second);
-    train.lastMoves.push_back(swap);
+  for (; train.lastMoves.size() > best_length; train.lastMoves.pop_back()) {
+    train.moveBox(train.lastMoves.back().first, train.lastMoves.back().second);
   }
-  return true;
+  return best_length > 0;
 }
 
-bool undoSwaps(State &train) {
-  for (unsigned i = train.lastMoves.size(); i-- > 0;) {
-    auto &swap = train.lastMoves[i];
-    train.moveBox(swap.first, swap.second);
+// Compound moves seeded from the lightest and heaviest trucks of the last evaluation, for when no move between two
+// trucks helps any more
+bool compoundMove(State &train) {
+  int heavy = train.maxIndex, light = train.minIndex;
+  if (heavy == -1 || heavy == light) return false;
+  switch (train.rng.bounded(3)) {
+    case 0:
+      return ejectionChain(train, heavy, light);
+    case 1:
+      return swapTwoForOne(train, heavy, light);
+    default:
+      return swapTwoForOne(train, light, heavy);
   }
 }
 
 void nextState(State &train) {
-  static random_device              rd;
-  static mt19937_64                 g(rd());
-  static uniform_int_distribution<> d(0, NB_TRUCK - 1);
   // try and swap from two random trucks
   train.lastMoves.clear();
+  if (chainMoves_s && train.rng.bounded(CHAIN_PERIOD) == 0 && compoundMove(train)) return;
   bool swapResult = false;
   while (!swapResult) {
-    int t1Index = d(g);
-    int t2Index = d(g);
-    swapResult  = swapBoxes(train, t1Index, t2Index);
+    int t1Index = train.rng.bounded(train.nbTruck);
+    int t2Index = train.rng.bounded(train.nbTruck);
+    swapResult  = randomMoves_s ? swapRandomBoxes(train, t1Index, t2Index) : swapBoxes(train, t1Index, t2Index);
+  }
+}
+
+// Whether a weight is given in WEIGHT_UNIT, which the lower bound and the exact search count in
+bool inWeightUnits(double weight) { return fabs(llround(weight / WEIGHT_UNIT) * WEIGHT_UNIT - weight) < GAP_EPSILON; }
+bool inWeightUnits(State &train) {
+  for (auto &box : train.boxes) {
+    if (!inWeightUnits(box.weight)) return false;
+  }
+  return true;
+}
+
+// Lower bound of the spread between the heaviest and the lightest truck, from the weights alone:
+//  - weights given in WEIGHT_UNIT are multiples of their greatest common divisor g, so unless the total splits into
+//    nbTruck multiples of g the trucks cannot all weigh the same, and the spread is at least g. A single finer weight
+//    drops this part.
+//  - among the k * nbTruck + 1 heaviest boxes, some truck gets k + 1 of them: the heaviest truck weighs at least the
+//    k + 1 lightest of those, and the lightest truck at most the average of what is left to the others
+// The volumes only tell whether the boxes can fit the fleet at all: -1 when their total is over the fleet capacity,
+// or when more boxes than trucks take over half a truck.
+double spreadLowerBound(State &train) {
+  int            nbTruck = train.nbTruck;
+  vector<double> weights;
+  double         total = 0, volume = 0;
+  long long      unit  = 0, units = 0;
+  int            bulky = 0;
+  bool           whole = true;  // every weight is a multiple of WEIGHT_UNIT
+  for (auto &box : train.boxes) {
+    weights.push_back(box.weight);
+    total += box.weight;
+    volume += box.volume;
+    bulky += (box.volume > maxVolume_s / 2);
+    long long hundredths = llround(box.weight / WEIGHT_UNIT);
+    unit                 = __gcd(unit, hundredths);
+    units += hundredths;
+    whole &= inWeightUnits(box.weight);
+  }
+  if (volume > nbTruck * maxVolume_s || bulky > nbTruck) return -1;
+  if (nbTruck < 2) return 0;
+
+  double bound = (whole && unit > 0 && (units / unit) % nbTruck != 0 ? unit * WEIGHT_UNIT : 0);
+  sort(weights.begin(), weights.end(), greater<double>());
+  double heaviest = total / nbTruck;
+  for (int k = 0; (long long)k * nbTruck < (long long)weights.size(); k++) {
+    double lightest = 0;  // the k + 1 lightest of the k * nbTruck + 1 heaviest boxes
+    for (int i = k * nbTruck - k; i <= k * nbTruck; i++) lightest += weights[i];
+    heaviest = max(heaviest, lightest);
   }
+  return max(bound, (nbTruck * heaviest - total) / (nbTruck - 1));
+}
+
+// Spread of a state, and whether it is within gapTolerance_s of the lower bound
+double spread(State &train) {
+  evaluate(train);
+  return train.trucks[train.maxIndex].weight - train.trucks[train.minIndex].weight;
+}
+bool closeToBound(State &train) {
+  return gapTolerance_s >= 0 && spread(train) <= spreadBound_s + gapTolerance_s + GAP_EPSILON;
 }
 
+// The end of the loop, or of the search as soon as the walk is provably close enough to the optimum. The trucks
+// found lightest and heaviest by the last evaluation are those of the current state, unless the move evaluated last
+// was undone: their spread is then no more than the current one, so it is only worth a full pass over the trucks when
+// that spread is close enough. The state the walk stops on is left in `train`, it is not always the lowest energy one.
 void updateCounter(State &train, long double &c) {
-  time_point<high_resolution_clock> end     = high_resolution_clock::now();
-  duration<double>                  elapsed = end - train.start;
-  c                                         = (1.0 - elapsed.count() / loopTime_s);
+  c = 1.0 - train.timer.tick();
+  if (gapTolerance_s >= 0 &&
+      train.trucks[train.maxIndex].weight - train.trucks[train.minIndex].weight <=
+          spreadBound_s + gapTolerance_s + GAP_EPSILON &&
+      closeToBound(train))
+    c = 0;
 }
 
 void basicInit(State &train) {
@@ -323,43 +987,294 @@ void basicInit(State &train) {
 void randInit(State &train) {
   int truckIndex;
   for (auto &box : train.boxes) {
-    truckIndex = rand() % (NB_TRUCK);
+    truckIndex = train.rng.bounded(train.nbTruck);
     while (!train.trucks[truckIndex].checkNewBox(box)) {
-      truckIndex = rand() % (NB_TRUCK);
+      truckIndex = train.rng.bounded(train.nbTruck);
     }
     train.insertBox(box.index, truckIndex);
   }
 }
 
+// Box indices by decreasing weight, each weight being scaled by a random factor in [1 - noise, 1 + noise]
+vector<pair<double, int> > sortedBoxes(State &train, double noise) {
+  vector<pair<double, int> > order;
+  order.reserve(train.nbBox);
+  for (auto &box : train.boxes) {
+    order.push_back(pair<double, int>(box.weight * (1 + noise * (2 * train.rng.uniform() - 1)), box.index));
+  }
+  sort(order.begin(), order.end(), greater<pair<double, int> >());
+  return order;
+}
+
+// Each box goes to the lightest truck with room for it; if no truck has room, to the one with the most room, which then
+// goes over capacity and is reported
+void lptPlace(State &train, const vector<int> &boxIndexes) {
+  int overflows = 0;
+  priority_queue<pair<double, int>, vector<pair<double, int> >, greater<pair<double, int> > > lightest;
+  for (auto &truck : train.trucks) {
+    lightest.push(pair<double, int>(truck.weight, truck.index));
+  }
+  vector<pair<double, int> > full;
+  for (auto boxIndex : boxIndexes) {
+    Box &box = train.boxes[boxIndex];
+    while (!lightest.empty() && !train.trucks[lightest.top().second].checkNewBox(box)) {
+      full.push_back(lightest.top());
+      lightest.pop();
+    }
+    int truckIndex;
+    if (!lightest.empty()) {
+      truckIndex = lightest.top().second;
+      lightest.pop();
+    } else {
+      truckIndex = 0;
+      for (auto &truck : train.trucks) {
+        if (truck.volume < train.trucks[truckIndex].volume) truckIndex = truck.index;
+      }
+      overflows++;
+    }
+    train.insertBox(boxIndex, truckIndex);
+    lightest.push(pair<double, int>(train.trucks[truckIndex].weight, truckIndex));
+    for (auto &truck : full) {
+      lightest.push(truck);
+    }
+    full.clear();
+  }
+  if (overflows > 0) cerr << "INIT: no room left for " << overflows << " boxes, loaded over capacity" << endl;
+}
+
+// Longest processing time first: heaviest boxes first, each into the lightest truck with room
+void lptInit(State &train, double noise) {
+  vector<int> boxIndexes;
+  boxIndexes.reserve(train.nbBox);
+  for (auto &item : sortedBoxes(train, noise)) {
+    boxIndexes.push_back(item.second);
+  }
+  lptPlace(train, boxIndexes);
+}
+
+// Karmarkar-Karp differencing over the KK_MAX_BOXES heaviest boxes: every box starts as a partial partition of its
+// own, and the two partitions with the largest spreads are merged by pairing the heaviest group of one with the
+// lightest group of the other, until a single partition is left. Its groups are loaded one per truck as far as
+// volumes allow, then the leftovers and the lighter boxes go through lptPlace.
+void kkInit(State &train, double noise) {
+  struct Partition {
+    vector<double> weights;  // decreasing
+    vector<int>    groups;   // index in groups, -1 for an empty group
+  };
+  vector<pair<double, int> > order = sortedBoxes(train, noise);
+  int                        k     = train.nbTruck;
+  int                        m     = min((int)order.size(), KK_MAX_BOXES);
+  vector<vector<int> >       groups(m);
+  vector<Partition>          partitions(m);
+  priority_queue<pair<double, int> > widest;
+  for (int i = 0; i < m; i++) {
+    groups[i].push_back(order[i].second);
+    partitions[i].weights.assign(k, 0);
+    partitions[i].groups.assign(k, -1);
+    partitions[i].weights[0] = order[i].first;
+    partitions[i].groups[0]  = i;
+    widest.push(pair<double, int>(order[i].first, i));
+  }
+  auto mergeGroups = [&groups](int g1, int g2) {
+    if (g1 == -1 || g2 == -1) return max(g1, g2);
+    if (groups[g1].size() < groups[g2].size()) swap(g1, g2);
+    groups[g1].insert(groups[g1].end(), groups[g2].begin(), groups[g2].end());
+    vector<int>().swap(groups[g2]);
+    return g1;
+  };
+  vector<pair<double, int> > merged(k);
+  while (widest.size() > 1) {
+    Partition &a = partitions[widest.top().second];
+    widest.pop();
+    Partition &b = partitions[widest.top().second];
+    widest.pop();
+    for (int i = 0; i < k; i++) {
+      merged[i] = pair<double, int>(a.weights[i] + b.weights[k - 1 - i], mergeGroups(a.groups[i], b.groups[k - 1 - i]));
+    }
+    sort(merged.begin(), merged.end(), greater<pair<double, int> >());
+    for (int i = 0; i < k; i++) {
+      a.weights[i] = merged[i].first;
+      a.groups[i]  = merged[i].second;
+    }
+    vector<double>().swap(b.weights);
+    vector<int>().swap(b.groups);
+    widest.push(pair<double, int>(a.weights[0] - a.weights[k - 1], &a - &partitions[0]));
+  }
+
+  vector<int> leftovers;
+  if (m > 0) {
+    Partition &result = partitions[widest.top().second];
+    for (int i = 0; i < k; i++) {
+      if (result.groups[i] == -1) continue;
+      for (auto boxIndex : groups[result.groups[i]]) {
+        if (train.trucks[i].checkNewBox(train.boxes[boxIndex])) {
+          train.insertBox(boxIndex, i);
+        } else {
+          leftovers.push_back(boxIndex);
+        }
+      }
+    }
+  }
+  for (int i = m; i < (int)order.size(); i++) {
+    leftovers.push_back(order[i].second);
+  }
+  lptPlace(train, leftovers);
+}
+
+// Depth-first branch and bound on the spread, over the boxes by decreasing weight, each tried in the trucks from the
+// lightest up so that the first complete assignment is LPT's. Weights are counted in WEIGHT_UNIT, which keeps the
+// bounds exact. A partial assignment is cut when it cannot end with a spread below the best one found:
+//  - no truck may go over the target weight plus that spread, as the lightest truck ends at most at the target
+//  - every truck must end at least that spread below max(heaviest truck, target weight), and the weight left to place
+//    must cover what the trucks are missing
+//  - the largest box left must fit in the truck with the most room
+// Trucks with the same load are interchangeable, a box only tries one of them: among others, a single empty truck.
+struct ExactSearch {
+  int                               nbTruck;
+  vector<int>                       order;      // box indices by decreasing weight
+  vector<long long>                 weights;    // by rank in order
+  vector<double>                    volumes;    // by rank in order
+  vector<long long>                 remaining;  // weight of the boxes from rank i on
+  vector<double>                    largest;    // largest volume of the boxes from rank i on
+  vector<long long>                 load;       // by truck
+  vector<double>                    volume;     // by truck
+  vector<int>                       truckOf, bestTruckOf;
+  vector<vector<int> >              candidates;  // by rank, trucks to try
+  long long                         floorTarget, ceilTarget, best, goal, nodes;
+  time_point<high_resolution_clock> deadline;
+  bool                              timeout;
+
+  ExactSearch(State &train)
+      : nbTruck(train.nbTruck), load(nbTruck, 0), volume(nbTruck, 0), candidates(train.nbBox), nodes(0), timeout(false) {
+    for (auto &box : sortedBoxes(train, 0)) order.push_back(box.second);
+    int n = order.size();
+    remaining.assign(n + 1, 0);
+    largest.assign(n + 1, 0);
+    for (int i = 0; i < n; i++) {
+      weights.push_back(llround(train.boxes[order[i]].weight / WEIGHT_UNIT));
+      volumes.push_back(train.boxes[order[i]].volume);
+    }
+    for (int i = n; i-- > 0;) {
+      remaining[i] = remaining[i + 1] + weights[i];
+      largest[i]   = max(largest[i + 1], volumes[i]);
+    }
+    floorTarget = remaining[0] / nbTruck;
+    ceilTarget  = (remaining[0] + nbTruck - 1) / nbTruck;
+    best        = LLONG_MAX / 4;
+    goal        = gapTolerance_s < 0 ? -1 : (long long)floor((spreadBound_s + gapTolerance_s) / WEIGHT_UNIT + 1e-6);
+    truckOf.assign(n, -1);
+  }
+
+  // true when the search must stop: close enough to the lower bound, or out of time
+  bool search(int i) {
+    if (++nodes % EXACT_CLOCK_PERIOD == 0 && high_resolution_clock::now() >= deadline) timeout = true;
+    if (timeout) return true;
+    long long heaviest = *max_element(load.begin(), load.end());
+    if (i == (int)order.size()) {
+      long long spread = heaviest - *min_element(load.begin(), load.end());
+      if (spread < best) {
+        best        = spread;
+        bestTruckOf = truckOf;
+      }
+      return best <= goal;
+    }
+    long long lowest = max(heaviest, ceilTarget) - best + 1, missing = 0;
+    double    room   = 0;
+    for (int t = 0; t < nbTruck; t++) {
+      missing += max(0LL, lowest - load[t]);
+      room = max(room, maxVolume_s - volume[t]);
+    }
+    if (missing > remaining[i] || largest[i] > room) return false;
+
+    vector<int> &trucks = candidates[i];
+    trucks.clear();
+    for (int t = 0; t < nbTruck; t++) {
+      if (load[t] + weights[i] <= floorTarget + best - 1 && volume[t] + volumes[i] <= maxVolume_s) trucks.push_back(t);
+    }
+    sort(trucks.begin(), trucks.end(), [this](int a, int b) {
+      return load[a] < load[b] || (load[a] == load[b] && volume[a] < volume[b]);
+    });
+    for (size_t c = 0; c < trucks.size(); c++) {
+      int t = trucks[c];
+      if (c > 0 && load[t] == load[trucks[c - 1]] && volume[t] == volume[trucks[c - 1]]) continue;
+      load[t] += weights[i];
+      volume[t] += volumes[i];
+      truckOf[i] = t;
+      bool stop  = search(i + 1);
+      load[t] -= weights[i];
+      volume[t] -= volumes[i];
+      if (stop) return true;
+    }
+    return false;
+  }
+
+  // Searches until `end`: true when the best assignment is optimal or close enough to the lower bound
+  bool solve(time_point<high_resolution_clock> end) {
+    deadline = end;
+    search(0);
+    return !timeout && !bestTruckOf.empty();
+  }
+
+  void store(State &train) {
+    train.reset();
+    for (size_t i = 0; i < order.size(); i++) train.insertBox(order[i], bestTruckOf[i]);
+  }
+};
+
+// First state of an annealing run; restarts perturb the constructive heuristics so that they do not always start
+// from the same point
+void initState(State &train, bool restart) {
+  switch (init_s) {
+    case LPT_INIT:
+      lptInit(train, restart ? INIT_NOISE : 0);
+      break;
+    case KK_INIT:
+      kkInit(train, restart ? INIT_NOISE : 0);
+      break;
+    case RAND_INIT:
+      randInit(train);
+      break;
+    default:
+      if (restart) {
+        randInit(train);
+      } else {
+        basicInit(train);
+      }
+      break;
+  }
+}
+
 void printState(State &train, int i) {
   cerr << i << "," << train.minIndex << "," << train.trucks[train.minIndex].weight << "," << train.maxIndex << ","
        << train.trucks[train.maxIndex].weight << ","
-       << (train.trucks[train.maxIndex].weight - train.trucks[train.minIndex].weight) << endl;
+       << (train.trucks[train.maxIndex].weight - train.trucks[train.minIndex].weight) << ",gap="
+       << (train.trucks[train.maxIndex].weight - train.trucks[train.minIndex].weight) - spreadBound_s << endl;
 }
 
-void readInputs(State &train) {
+void readInputs(State &train, InputReader &reader) {
   double targetWeight = 0;
   double avgVolume    = 0;
-  for (int i = 0; i < NB_TRUCK; ++i) {
+  for (int i = 0; i < train.nbTruck; ++i) {
     train.trucks.push_back(Truck(i));
   }
+  train.boxes.reserve(train.nbBox);
+  train.boxPosition.assign(train.nbBox, -1);
+  train.boxSlot.assign(train.nbBox, -1);
   for (int i = 0; i < train.nbBox; i++) {
-    double weight;
-    double volume;
-    cin >> weight >> volume;
-    cin.ignore();
-    Box b(i, weight, volume);
+    double weight = reader.readDouble();
+    double volume = reader.readDouble();
+    Box    b(i, weight, volume);
     train.addBox(b);
-    train.boxPosition.push_back(-1);
     targetWeight += weight;
     avgVolume += volume;
   }
-  targetWeight /= NB_TRUCK;
+  targetWeight /= train.nbTruck;
   train.targetWeight = targetWeight;
-  cerr << "STATS: target weight=" << targetWeight << ", average volume=" << avgVolume / NB_TRUCK << endl << endl;
+  cerr << "STATS: target weight=" << targetWeight << ", average volume=" << avgVolume / train.nbTruck << endl << endl;
 }
 
 void swapMinMax(State &train) {
+  if (largeScale_s == 1) return;  // swapBoxes is quadratic in the number of boxes per truck
   bool   swapResult = true;
   int    i          = 0;
   double score      = evaluate(train);
@@ -370,69 +1285,243 @@ void swapMinMax(State &train) {
   }
 }
 
-int main(int argc, char const *argv[]) {
-  time_point<high_resolution_clock> start, end;
-  start = high_resolution_clock::now();
+template <typename schedule>
+State annealWith(State &train, long double &count) {
+  schedule cooling;
+  telemetry_s.begin();
+  State best = simulated_annealing(train, count, evaluate, cooling, nextState, undoSwaps, updateCounter, telemetry_s);
+  cerr << "cooling " << cooling2str[cooling_s] << ": T0=" << cooling.t0 << ", reheats=" << cooling.reheats << endl;
+  return best;
+}
 
-  if (argc >= 3) {
-    maxT_s            = atof(argv[1]);
-    scoreMultiplier_s = atof(argv[2]);
+// Simulated annealing of train with the schedule of cooling_s
+State anneal(State &train, long double &count) {
+  switch (cooling_s) {
+    case EXP_COOLING:
+      return annealWith<ExponentialCooling>(train, count);
+    case LUNDY_MEES_COOLING:
+      return annealWith<LundyMeesCooling>(train, count);
+    case ADAPTIVE_COOLING:
+      return annealWith<AdaptiveCooling>(train, count);
+    default:
+      return annealWith<LinearCooling>(train, count);
   }
-  if (argc == 4) {
-    loopTime_s = atof(argv[3]);
+}
+
+int main(int argc, char const *argv[]) {
+  // options first, then the positional Tmax, ScoreX and loopTime
+  vector<const char *> args;
+  const char          *telemetryPath   = NULL;
+  long long            telemetryStride = TELEMETRY_STRIDE;
+  for (int i = 1; i < argc; i++) {
+    string arg = argv[i];
+    if (arg == "--pt" && i + 1 < argc) {
+      nbReplica_s = atoi(argv[++i]);
+      if (nbReplica_s <= 0) nbReplica_s = max(2u, thread::hardware_concurrency());
+    } else if (arg == "--random-moves") {
+      randomMoves_s = true;
+    } else if (arg == "--no-chains") {
+      chainMoves_s = false;
+    } else if (arg == "--trucks" && i + 1 < argc) {
+      nbTruck_s = atoi(argv[++i]);
+    } else if (arg == "--capacity" && i + 1 < argc) {
+      maxVolume_s = atof(argv[++i]);
+    } else if (arg == "--time" && i + 1 < argc) {
+      maxTime_s = atof(argv[++i]);
+    } else if (arg == "--init" && i + 1 < argc) {
+      init_s = find(init2str.begin(), init2str.end(), argv[++i]) - init2str.begin();
+      if (init_s == INIT_TYPE_MAX) init_s = BASIC_INIT;
+    } else if (arg == "--cooling" && i + 1 < argc) {
+      cooling_s = find(cooling2str.begin(), cooling2str.end(), argv[++i]) - cooling2str.begin();
+      if (cooling_s == COOLING_TYPE_MAX) cooling_s = ADAPTIVE_COOLING;
+    } else if (arg == "--large") {
+      largeScale_s = 1;
+    } else if (arg == "--exact") {
+      exact_s = 1;
+    } else if (arg == "--no-exact") {
+      exact_s = 0;
+    } else if (arg == "--gap" && i + 1 < argc) {
+      gapTolerance_s = atof(argv[++i]);
+    } else if (arg == "--telemetry" && i + 1 < argc) {
+      telemetryPath = argv[++i];
+    } else if (arg == "--telemetry-stride" && i + 1 < argc) {
+      telemetryStride = atoll(argv[++i]);
+    } else if (arg == "--seed" && i + 1 < argc) {
+      seed_s = strtoull(argv[++i], NULL, 10);
+    } else {
+      args.push_back(argv[i]);
+    }
+  }
+  if (args.size() >= 2) {
+    maxT_s            = atof(args[0]);
+    scoreMultiplier_s = atof(args[1]);
+    calibrate_s       = false;
   }
+  if (args.size() == 3) {
+    loopTime_s = atof(args[2]);
+  }
+  loopTime_s = min(loopTime_s, maxTime_s * (1 - TIME_SAFETY));
 
-  cerr << "working with Tmax=" << maxT_s << ", ScoreX=" << scoreMultiplier_s << ", loopTime=" << loopTime_s << "s"
-       << endl;
+  // the whole run is a single turn, timed from here: parsing the options takes no time
+  TurnBudget budget(maxTime_s, maxTime_s, TIME_SAFETY);
+  budget.startTurn();
+  time_point<high_resolution_clock> start = budget.turnStart;
+  if (telemetryPath) {
+    telemetry_s.open(telemetryPath, telemetryStride, start);
+    if (telemetry_s.file == NULL) cerr << "cannot write telemetry to " << telemetryPath << endl;
+  }
 
-  int boxCount;
-  cin >> boxCount;
-  cin.ignore();
+  cerr << "working with Tmax=";
+  if (calibrate_s) {
+    cerr << "calibrated";
+  } else {
+    cerr << maxT_s;
+  }
+  cerr << ", ScoreX=" << scoreMultiplier_s << ", loopTime=" << loopTime_s << "s";
+  if (nbReplica_s > 0) cerr << ", replicas=" << nbReplica_s;
+  cerr << ", init=" << init2str[init_s] << ", cooling=" << cooling2str[cooling_s] << ", seed=" << seed_s << endl;
+  seeder_s.seed(seed_s);
 
-  State train(boxCount, NB_TRUCK, start);
-  readInputs(train);
+  InputReader reader(stdin);
+  int         boxCount = reader.readInt();
+  if (largeScale_s == -1) largeScale_s = (boxCount > LARGE_SCALE_BOXES_PER_TRUCK * nbTruck_s);
+  if (largeScale_s == 1) {
+    cerr << "large scale mode: " << boxCount << " boxes in " << nbTruck_s << " trucks, random moves only" << endl;
+    randomMoves_s = true;
+  }
 
-  /**************
-   * BASIC MODE *
-   **************/
-  basicInit(train);
-  swapMinMax(train);
-  // Simulated annealing
-  long double count      = 1.0;
-  State       best_train = simulated_annealing(train, count, evaluate, tf, nextState, undoSwaps, updateCounter);
-  double      best_score = evaluate(best_train);
-  printState(best_train, count);
-  end                         = high_resolution_clock::now();
-  duration<double> elapsed_ms = end - start;
+  State train(boxCount, nbTruck_s, start);
+  readInputs(train, reader);
+  budget.inputParsed();
+  spreadBound_s = spreadLowerBound(train);
+  if (spreadBound_s < 0) {
+    cerr << "BOUND: the boxes cannot fit the fleet" << endl;
+    spreadBound_s = 0;
+  }
+  cerr << "BOUND: spread >= " << spreadBound_s << ", stopping within " << gapTolerance_s << endl;
+
+  long double count = 1.0;
+  State       best_train(boxCount, nbTruck_s, start);
+  State       exact_train(boxCount, nbTruck_s, start);
+  bool        exactFound = false, solved = false;
 
-  while (MAX_TIME - elapsed_ms.count() > loopTime_s) {
+  // the exact search rounds the weights to WEIGHT_UNIT: on finer weights it only proves anything on the rounded ones,
+  // so it is not picked by itself, and when asked for, its split only seeds the annealing
+  bool exactWeights = inWeightUnits(train);
+  if (exact_s == -1) exact_s = (boxCount <= EXACT_MAX_BOXES && exactWeights);
+  if (exact_s == 1) {
+    ExactSearch exact(train);
+    auto        end = start + duration_cast<high_resolution_clock::duration>(
+                                  duration<double>(min(EXACT_TIME_FRACTION * loopTime_s, budget.remaining())));
+    bool        done = exact.solve(end);
+    solved           = done && exactWeights;
+    exactFound       = !exact.bestTruckOf.empty();
+    cerr << "EXACT: " << exact.nodes << " nodes, "
+         << (solved                ? "solved"
+             : done && exactFound ? "solved on weights rounded to hundredths, annealing from here"
+             : exactFound         ? "timed out, annealing from here"
+                                  : "nothing found, annealing");
+    if (exactFound) cerr << ", spread=" << exact.best * WEIGHT_UNIT;
+    cerr << endl;
+    // the annealing starts from the best split found, and keeps the end of its first loop
     train.reset();
-    randInit(train);
+    if (exactFound) {
+      exact.store(train);
+      evaluate(train);
+      exact_train = train;
+    }
+    train.timer.reset(start, loopTime_s);
+  }
+
+  if (solved) {
+    best_train = exact_train;
+  } else if (nbReplica_s > 0) {
+    /***************************
+     * PARALLEL TEMPERING MODE *
+     ***************************/
+    vector<State> replicas;
+    for (int r = 0; r < nbReplica_s; r++) {
+      if (r > 0 || !exactFound) {
+        train.reset();
+        initState(train, r > 0);
+      }
+      swapMinMax(train);
+      replicas.push_back(train);
+      replicas.back().rng.seed(nextSeed());
+    }
+    // starting ladder, geometric from the coldest rung (Tmax * PT_MIN_RATIO) up to Tmax, Tmax being calibrated as the
+    // starting temperature of the annealing is; parallel_tempering then tightens it until neighbours swap
+    double uphill = (calibrate_s ? meanUphill(replicas[0], evaluate, nextState, undoSwaps) : 0);
+    double tMax   = (uphill > 0 ? -uphill / log(CALIBRATION_ACCEPTANCE) : maxT_s);
+    vector<double> temperatures(nbReplica_s, tMax);
+    for (int r = 0; r < nbReplica_s - 1; r++) {
+      temperatures[r] = tMax * pow(PT_MIN_RATIO, 1.0 - (double)r / (nbReplica_s - 1));
+    }
+    cerr << "ladder: T=" << temperatures[0] << " to " << tMax << (uphill > 0 ? ", calibrated" : ", from Tmax") << endl;
+    vector<RungStats> stats;
+    auto              timeout = [&]() {
+      if (budget.shouldStop()) return true;
+      for (auto &replica : replicas) {
+        if (closeToBound(replica)) return true;
+      }
+      return false;
+    };
+    best_train = parallel_tempering(replicas, temperatures, stats, evaluate, nextState, undoSwaps, timeout);
+    for (auto &replica : replicas) {
+      if (closeToBound(replica) && !closeToBound(best_train)) best_train = replica;
+    }
+    evaluate(best_train);
+
+    for (int r = 0; r < nbReplica_s; r++) {
+      cerr << "rung " << r << ": T=" << temperatures[r] << ", moves=" << stats[r].moves
+           << ", acceptance=" << (double)stats[r].accepted / max(1LL, stats[r].moves);
+      if (r + 1 < nbReplica_s) cerr << ", swap=" << (double)stats[r].swaps / max(1LL, stats[r].swapTries);
+      cerr << endl;
+    }
+  } else {
+    /**************
+     * BASIC MODE *
+     **************/
+    if (!exactFound) initState(train, false);
     swapMinMax(train);
     // Simulated annealing
-    long double count     = 1.0;
-    State       new_train = simulated_annealing(train, count, evaluate, tf, nextState, undoSwaps, updateCounter);
-    double      new_score = evaluate(new_train);
-    printState(new_train, count);
+    best_train = anneal(train, count);
+    if (closeToBound(train) && !closeToBound(best_train)) best_train = train;
+    double best_score = evaluate(best_train);
+    printState(best_train, count);
 
-    if (new_score < best_score) {
-      best_score = new_score;
-      best_train = move(new_train);
-    }
+    while (!closeToBound(best_train) && budget.remaining() > MIN_LOOP_FRACTION * loopTime_s) {
+      train.reset();
+      initState(train, true);
+      swapMinMax(train);
+      // the last restart gets whatever time is left
+      train.timer.reset(high_resolution_clock::now(), min(loopTime_s, budget.remaining()));
+      // Simulated annealing
+      long double count     = 1.0;
+      State       new_train = anneal(train, count);
+      if (closeToBound(train) && !closeToBound(new_train)) new_train = train;
+      double new_score = evaluate(new_train);
+      printState(new_train, count);
 
-    end        = high_resolution_clock::now();
-    elapsed_ms = end - start;
+      if (new_score < best_score || (closeToBound(new_train) && !closeToBound(best_train))) {
+        best_score = new_score;
+        best_train = move(new_train);
+      }
+    }
   }
 
+  if (exactFound && !solved && spread(exact_train) < spread(best_train)) best_train = exact_train;
+
   for (auto &pos : best_train.boxPosition) {
     cout << pos << " ";
   }
   cout << endl;
 
   printState(best_train, count);
-  cerr << "SCORE=" << (best_train.trucks[best_train.maxIndex].weight - best_train.trucks[best_train.minIndex].weight)
-       << endl;
-  end        = high_resolution_clock::now();
-  elapsed_ms = end - start;
-  cerr << "duration: " << elapsed_ms.count() << " s" << endl;
+  double best_spread = spread(best_train);
+  cerr << "SCORE=" << best_spread << " BOUND=" << spreadBound_s << " GAP=" << best_spread - spreadBound_s << endl;
+  telemetry_s.close();
+  budget.endTurn();
+  budget.report(cerr);
+  return 0;
 }
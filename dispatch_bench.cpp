@@ -0,0 +1,126 @@
+#include <math.h>
+#include <sys/resource.h>
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <condition_variable>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <queue>
+#include <random>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "turn_budget.h"
+
+// The bot is compiled as is, its main() becomes dispatch::main. Every header it includes must be included above, so
+// that its own #include lines are no-ops inside the namespace.
+namespace dispatch {
+#include "dispatch.cpp"
+}
+
+using namespace std;
+using namespace std::chrono;
+
+static const int    sizes[]       = {1000, 10000, 100000, 1000000};
+static const double checkpoints[] = {0.01, 0.03, 0.1, 0.3, 1, 3, 10, 30, 100};
+
+// Synthetic manifest: weights in [1, 50], volumes drawn so that the boxes fill about 80% of the fleet capacity
+void generate(FILE *file, int nbBox, int nbTruck, uint64_t seed) {
+  dispatch::Rng rng(seed);
+  double        maxVolume = 2 * 0.8 * nbTruck * dispatch::maxVolume_s / nbBox;
+  fprintf(file, "%d\n", nbBox);
+  for (int i = 0; i < nbBox; i++) {
+    fprintf(file, "%.2f %.5f\n", 1 + 49 * rng.uniform(), maxVolume * rng.uniform());
+  }
+  rewind(file);
+}
+
+int main(int argc, char const *argv[]) {
+  double   budget = (argc > 1 ? atof(argv[1]) : 10);
+  int      nbTruck = (argc > 2 ? atoi(argv[2]) : NB_TRUCK);
+  string   init    = (argc > 3 ? argv[3] : "rand");
+  double   target  = (argc > 4 ? atof(argv[4]) : 1);
+  uint64_t seed    = 42;
+
+  dispatch::seeder_s.seed(seed);
+  dispatch::init_s = find(dispatch::init2str.begin(), dispatch::init2str.end(), init) - dispatch::init2str.begin();
+  if (dispatch::init_s == dispatch::INIT_TYPE_MAX) dispatch::init_s = dispatch::RAND_INIT;
+  cout << "init=" << dispatch::init2str[dispatch::init_s] << endl;
+  cout << "boxes,parse_ms,MB/s,peak_rss_MB,iterations,init_ms,spread@init,s_to_" << target;
+  for (double checkpoint : checkpoints) {
+    if (checkpoint <= budget) cout << ",spread@" << checkpoint << "s";
+  }
+  cout << endl;
+
+  for (int nbBox : sizes) {
+    FILE *file = tmpfile();
+    generate(file, nbBox, nbTruck, seed + nbBox);
+    fseek(file, 0, SEEK_END);
+    double megabytes = ftell(file) / 1e6;
+    rewind(file);
+
+    dispatch::nbTruck_s     = nbTruck;
+    dispatch::loopTime_s    = budget;
+    dispatch::largeScale_s  = (nbBox > LARGE_SCALE_BOXES_PER_TRUCK * nbTruck);
+    dispatch::randomMoves_s = (dispatch::largeScale_s == 1);
+
+    auto                  parseStart = high_resolution_clock::now();
+    dispatch::InputReader reader(file);
+    int                   boxCount = reader.readInt();
+    dispatch::State       train(boxCount, nbTruck, parseStart);
+    dispatch::readInputs(train, reader);
+    duration<double, milli> parseTime = high_resolution_clock::now() - parseStart;
+    fclose(file);
+
+    auto initStart = high_resolution_clock::now();
+    dispatch::initState(train, false);
+    dispatch::swapMinMax(train);
+    duration<double, milli> initTime = high_resolution_clock::now() - initStart;
+    train.timer.reset(high_resolution_clock::now(), budget);
+
+    // best spread seen so far, sampled every 1024 iterations and reported when crossing each checkpoint
+    vector<double> quality;
+    double         initSpread = dispatch::spread(train);
+    double         best       = initSpread;
+    double         reached    = (best <= target ? 0 : -1);
+    long long      iterations = 0;
+    auto           counter    = [&](dispatch::State &state, long double &c) {
+      dispatch::updateCounter(state, c);
+      if ((++iterations & 1023) != 0 && c > 0) return;
+      best = min(best, dispatch::spread(state));
+      if (reached < 0 && best <= target) reached = state.timer.elapsed;
+      while (quality.size() < sizeof(checkpoints) / sizeof(checkpoints[0]) &&
+             checkpoints[quality.size()] <= state.timer.elapsed && checkpoints[quality.size()] <= budget) {
+        quality.push_back(best);
+      }
+    };
+    long double count = 1.0;
+    dispatch::State result =
+        dispatch::simulated_annealing(train, count, dispatch::evaluate, dispatch::LinearCooling(), dispatch::nextState,
+                                      dispatch::undoSwaps, counter);
+    best = min(best, dispatch::spread(result));
+    if (reached < 0 && best <= target) reached = budget;
+    while (quality.size() < sizeof(checkpoints) / sizeof(checkpoints[0]) && checkpoints[quality.size()] <= budget) {
+      quality.push_back(best);
+    }
+
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    cout << nbBox << "," << fixed << setprecision(1) << parseTime.count() << "," << megabytes / parseTime.count() * 1e3
+         << "," << usage.ru_maxrss / 1024.0 << "," << iterations << "," << initTime.count() << setprecision(2) << ","
+         << initSpread << "," << reached;
+    for (double q : quality) {
+      cout << "," << q;
+    }
+    cout << defaultfloat << endl;
+  }
+}
@@ -0,0 +1,81 @@
+#include <algorithm>
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+#define IMPROVEMENT_SHARE (0.9)  // of the improvement of a run, for the time it took to get there
+
+struct Row {
+  int       run;
+  double    time, energy, best, temperature, acceptance;
+  long long move;
+};
+
+struct Run {
+  vector<Row> rows;
+};
+
+// Runs of a telemetry file written by codingame_dp --telemetry, by run number
+bool load(const char *path, map<int, Run> &runs) {
+  FILE *file = fopen(path, "r");
+  if (file == NULL) return false;
+  char header[256];
+  if (fgets(header, sizeof(header), file) == NULL) {
+    fclose(file);
+    return false;
+  }
+  Row row;
+  while (fscanf(file, "%d,%lf,%lld,%lf,%lf,%lf,%lf", &row.run, &row.time, &row.move, &row.energy, &row.best,
+                &row.temperature, &row.acceptance) == 7) {
+    runs[row.run].rows.push_back(row);
+  }
+  fclose(file);
+  return true;
+}
+
+// Compares the annealing runs of telemetry files: per run, how long it lasted and how fast it moved, where its best
+// energy started and ended, when it had made IMPROVEMENT_SHARE of its improvement and when it last improved, and its
+// mean acceptance and last temperature. A run that stops improving long before its end is longer than it needs to be.
+int main(int argc, char const *argv[]) {
+  if (argc < 2) {
+    cerr << "usage: " << argv[0] << " telemetry.csv..." << endl;
+    return 1;
+  }
+  cout << "file,run,seconds,moves,moves_per_s,first_best,final_best,s_to_" << IMPROVEMENT_SHARE * 100
+       << "pct,s_to_last_best,mean_acceptance,final_temperature" << endl;
+  for (int f = 1; f < argc; f++) {
+    map<int, Run> runs;
+    if (!load(argv[f], runs)) {
+      cerr << "cannot read " << argv[f] << endl;
+      continue;
+    }
+    double overall = 0;
+    bool   any     = false;
+    for (auto &kv : runs) {
+      vector<Row> &rows = kv.second.rows;
+      if (rows.empty()) continue;
+      Row   &first = rows.front(), &last = rows.back();
+      double seconds = last.time - first.time, acceptance = 0;
+      double goal = first.best - IMPROVEMENT_SHARE * (first.best - last.best), reached = -1, improved = first.time;
+      for (size_t i = 0; i < rows.size(); i++) {
+        acceptance += rows[i].acceptance;
+        if (reached < 0 && rows[i].best <= goal) reached = rows[i].time - first.time;
+        if (i > 0 && rows[i].best < rows[i - 1].best) improved = rows[i].time;
+      }
+      cout << argv[f] << "," << kv.first << "," << fixed << setprecision(3) << seconds << "," << last.move << ","
+           << setprecision(0) << (seconds > 0 ? (last.move - first.move) / seconds : 0) << defaultfloat
+           << setprecision(6) << "," << first.best << "," << last.best << "," << fixed << setprecision(3) << reached
+           << "," << improved - first.time << "," << setprecision(4) << acceptance / rows.size() << defaultfloat
+           << setprecision(6) << "," << last.temperature << endl;
+      overall = (any ? min(overall, last.best) : last.best);
+      any     = true;
+    }
+    if (any) cout << argv[f] << ",best,,,,," << overall << ",,,," << endl;
+  }
+  return 0;
+}
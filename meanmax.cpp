@@ -1,11 +1,82 @@
 #include <algorithm>
+#include <chrono>
 #include <climits>
 #include <cmath>
+#include <cstdint>
+#include <immintrin.h>
 #include <iostream>
 #include <string>
 #include <vector>
 
+#include "turn_budget.h"
+
+#pragma GCC target("avx")
+#pragma GCC optimize("O3")
+#pragma GCC optimize("omit-frame-pointer")
+#pragma GCC optimize("unroll-all-loops")
+#pragma GCC optimize("inline")
+
 using namespace std;
+using namespace std::chrono;
+
+#define MAP_RADIUS (6000.0f)
+#define WATER_TOWN_RADIUS (3000.0f)
+#define MAX_THRUST (300)
+#define MAX_RAGE (300)
+#define LOOTER_RADIUS (400.0f)
+#define TANKER_THRUST (500.0f)
+#define TANKER_EMPTY_MASS (2.5f)
+#define TANKER_MASS_BY_WATER (0.5f)
+#define TANKER_FRICTION (0.40f)
+#define REAPER_MASS (0.5f)
+#define REAPER_FRICTION (0.20f)
+#define DESTROYER_MASS (1.5f)
+#define DESTROYER_FRICTION (0.30f)
+#define DOOF_MASS (1.0f)
+#define DOOF_FRICTION (0.25f)
+#define DOOF_RAGE_COEF (0.01f)
+#define SKILL_RANGE (2000.0f)
+#define SKILL_RADIUS (1000.0f)
+#define TAR_COST (30)
+#define TAR_DURATION (3)
+#define TAR_MASS_BONUS (10.0f)
+#define OIL_COST (30)
+#define OIL_DURATION (3)
+#define GRENADE_COST (60)
+#define GRENADE_DURATION (1)
+#define GRENADE_POWER (1000.0f)
+#define MIN_IMPULSE (30.0f)
+#define EPSILON (0.00001f)
+#define MAX_COLLISIONS (64)
+
+#define NB_PLAYER (3)
+#define NB_LOOTER (3 * NB_PLAYER)
+#define MAX_BODIES (32)
+#define MAX_WRECKS (32)
+#define MAX_EFFECTS (16)
+#define MAX_INDEXED (MAX_BODIES + MAX_WRECKS + MAX_EFFECTS)
+#define GRID_CELL (2000.0f)
+#define GRID_SIZE (6)  // cells per side, the grid covers the map disk; units outside are clamped to the border cells
+#define MAX_UNITS (128)
+#define UNIT_SLOTS (256)      // open addressing table of the unit ids, power of two
+#define DUMP_UNITS (false)    // print every unit of the turn to stderr
+
+#define SEARCH_DEPTH (5)
+#define POPULATION (12)
+#define FIRST_TURN_TIME (1.0)
+#define TURN_TIME (0.05)
+#define TURN_SAFETY (0.1)
+#define ORDER_DISTANCE (1000.0f)
+#define INTERCEPT_HORIZON (20)
+#define SKILL_DEPTH (3)
+#define SKILL_TIME (0.001)  // kept at the end of the turn for the skill pass
+#define MAX_SKILL_CANDIDATES (64)
+#define OPPONENT_EMA (0.2f)            // weight of the last turn in the prediction error averages
+#define PREDICTION_TOLERANCE (50.0f)  // a prediction closer than this to the observed position is a hit
+
+enum unitType { REAPER, DESTROYER, DOOF, TANKER, WRECK, TAR, OIL, GRENADE, UNIT_TYPE_MAX };
+static const float looterMass[]     = {REAPER_MASS, DESTROYER_MASS, DOOF_MASS};
+static const float looterFriction[] = {REAPER_FRICTION, DESTROYER_FRICTION, DOOF_FRICTION};
 
 typedef pair<int, int> Location;
 typedef pair<int, int> Speed;
@@ -42,15 +113,10 @@ struct Unit {
         nbWater(e),
         waterCapacity(e2) {}
 
-  int distance(Unit u) { return pow(loc.first - u.loc.first, 2) + pow(loc.second - u.loc.second, 2); }
-  void goTo(Unit u, bool fullSpeed = false) {
-    int dist = this->distance(u);
-    int acc  = 300;
-    if (!fullSpeed) {
-      if (dist < 600) acc = 150;
-      if (dist < 400) acc = 0;
-    }
-    cout << u.loc.first - speed.first << " " << u.loc.second - speed.second << " " << acc << endl;
+  // squared distance, coordinates stay below 2^15 so it fits an int
+  int distance(const Unit &u) const {
+    int dx = loc.first - u.loc.first, dy = loc.second - u.loc.second;
+    return dx * dx + dy * dy;
   }
   void print() {
     cerr << id << " " << type << " " << playerId << " " << mass << " " << radius << " " << loc.first << " "
@@ -58,12 +124,1054 @@ struct Unit {
   }
 };
 
+// The units of the turn, read in place into a preallocated array. Slots are found by unitId through an open
+// addressing table, looters by (player, type) and the other units through per-type lists of slots.
+struct UnitTable {
+  int  count;
+  Unit units[MAX_UNITS];
+  int  slotOf[UNIT_SLOTS];  // slot + 1 of the unit whose id hashes there, 0 when empty
+  int  looters[NB_PLAYER][3];
+  int  nbOfType[UNIT_TYPE_MAX];
+  int  ofType[UNIT_TYPE_MAX][MAX_UNITS];
+
+  UnitTable() { clear(); }
+
+  void clear() {
+    count = 0;
+    fill(slotOf, slotOf + UNIT_SLOTS, 0);
+    fill(&looters[0][0], &looters[0][0] + NB_PLAYER * 3, -1);
+    fill(nbOfType, nbOfType + UNIT_TYPE_MAX, 0);
+  }
+
+  // Read `unitCount` lines of units, units beyond MAX_UNITS are skipped
+  void read(istream &in, int unitCount) {
+    Unit overflow;
+    clear();
+    for (int i = 0; i < unitCount; i++) {
+      Unit &u = (count < MAX_UNITS ? units[count] : overflow);
+      float mass;
+      in >> u.id >> u.type >> u.playerId >> mass >> u.radius >> u.loc.first >> u.loc.second >> u.speed.first >>
+          u.speed.second >> u.nbWater >> u.waterCapacity;
+      in.ignore();
+      u.mass = mass;
+      if (count == MAX_UNITS || u.type < 0 || u.type >= UNIT_TYPE_MAX) continue;
+      if (DUMP_UNITS) u.print();
+      int h = u.id & (UNIT_SLOTS - 1);
+      while (slotOf[h]) h = (h + 1) & (UNIT_SLOTS - 1);
+      slotOf[h] = count + 1;
+      if (u.type <= DOOF && u.playerId >= 0 && u.playerId < NB_PLAYER) looters[u.playerId][u.type] = count;
+      ofType[u.type][nbOfType[u.type]++] = count;
+      count++;
+    }
+  }
+
+  Unit *find(int unitId) {
+    for (int h = unitId & (UNIT_SLOTS - 1); slotOf[h]; h = (h + 1) & (UNIT_SLOTS - 1)) {
+      if (units[slotOf[h] - 1].id == unitId) return &units[slotOf[h] - 1];
+    }
+    return nullptr;
+  }
+  Unit *looter(int player, int type) { return looters[player][type] == -1 ? nullptr : &units[looters[player][type]]; }
+};
+
+// What a looter does for one turn: thrust towards (x, y), or cast its skill there when skill is true
+struct Order {
+  float x, y;
+  int   thrust;
+  bool  skill;
+  Order() : x(0), y(0), thrust(0), skill(false) {}
+  Order(float tx, float ty, int t, bool s = false) : x(tx), y(ty), thrust(t), skill(s) {}
+};
+
+// Deterministic model of one Mean Max turn. Units are kept in struct-of-arrays float buffers so that the integration
+// and collision loops vectorize. Bodies are the units that move and collide: the looter of a player and type is at
+// 3 * player + type, tankers follow. Wrecks and skill effects only have a position and a radius.
+struct Simulation {
+  int   turn;
+  int   score[NB_PLAYER], rage[NB_PLAYER];
+  int   nbBody;
+  float x[MAX_BODIES], y[MAX_BODIES], vx[MAX_BODIES], vy[MAX_BODIES];
+  float mass[MAX_BODIES], friction[MAX_BODIES], radius[MAX_BODIES];
+  float effectiveMass[MAX_BODIES];  // mass plus the tar bonus of the current turn
+  int   id[MAX_BODIES], water[MAX_BODIES], capacity[MAX_BODIES];
+  int   nbWreck;
+  float wreckX[MAX_WRECKS], wreckY[MAX_WRECKS], wreckRadius[MAX_WRECKS];
+  int   wreckId[MAX_WRECKS], wreckWater[MAX_WRECKS];
+  int   nbEffect;
+  float effectX[MAX_EFFECTS], effectY[MAX_EFFECTS];
+  int   effectType[MAX_EFFECTS], effectDuration[MAX_EFFECTS];
+  int   nextId;
+
+  Simulation() : turn(0), nbBody(NB_LOOTER), nbWreck(0), nbEffect(0), nextId(0) {
+    for (int p = 0; p < NB_PLAYER; p++) {
+      score[p] = 0;
+      rage[p]  = 0;
+    }
+    for (int i = 0; i < MAX_BODIES; i++) {
+      x[i] = y[i] = vx[i] = vy[i] = 0;
+      mass[i] = effectiveMass[i] = 1;
+      friction[i] = radius[i] = 0;
+      id[i] = water[i] = capacity[i] = -1;
+    }
+  }
+
+  static int looter(int player, int type) { return 3 * player + type; }
+
+  void setLooter(int i, int uid, float px, float py, float pvx, float pvy) {
+    id[i]       = uid;
+    x[i]        = px;
+    y[i]        = py;
+    vx[i]       = pvx;
+    vy[i]       = pvy;
+    mass[i]     = looterMass[i % 3];
+    friction[i] = looterFriction[i % 3];
+    radius[i]   = LOOTER_RADIUS;
+    nextId      = max(nextId, uid + 1);
+  }
+  void addTanker(int uid, float px, float py, float pvx, float pvy, int w, int c, float r) {
+    if (nbBody == MAX_BODIES) return;
+    int i       = nbBody++;
+    id[i]       = uid;
+    x[i]        = px;
+    y[i]        = py;
+    vx[i]       = pvx;
+    vy[i]       = pvy;
+    water[i]    = w;
+    capacity[i] = c;
+    mass[i]     = TANKER_EMPTY_MASS + TANKER_MASS_BY_WATER * w;
+    friction[i] = TANKER_FRICTION;
+    radius[i]   = r;
+    nextId      = max(nextId, uid + 1);
+  }
+  void addWreck(int uid, float px, float py, float r, int w) {
+    if (nbWreck == MAX_WRECKS || w <= 0) return;
+    wreckId[nbWreck]     = uid;
+    wreckX[nbWreck]      = px;
+    wreckY[nbWreck]      = py;
+    wreckRadius[nbWreck] = r;
+    wreckWater[nbWreck]  = w;
+    nbWreck++;
+    nextId = max(nextId, uid + 1);
+  }
+  void addEffect(int type, float px, float py, int duration) {
+    if (nbEffect == MAX_EFFECTS) return;
+    effectType[nbEffect]     = type;
+    effectX[nbEffect]        = px;
+    effectY[nbEffect]        = py;
+    effectDuration[nbEffect] = duration;
+    nbEffect++;
+  }
+  void removeTanker(int i) {
+    nbBody--;
+    x[i]             = x[nbBody];
+    y[i]             = y[nbBody];
+    vx[i]            = vx[nbBody];
+    vy[i]            = vy[nbBody];
+    mass[i]          = mass[nbBody];
+    effectiveMass[i] = effectiveMass[nbBody];
+    friction[i]      = friction[nbBody];
+    radius[i]        = radius[nbBody];
+    id[i]            = id[nbBody];
+    water[i]         = water[nbBody];
+    capacity[i]      = capacity[nbBody];
+  }
+  void destroyTanker(int i) {
+    addWreck(nextId++, x[i], y[i], radius[i], water[i]);
+    removeTanker(i);
+  }
+
+  bool inEffect(int type, float px, float py) {
+    for (int e = 0; e < nbEffect; e++) {
+      float dx = px - effectX[e], dy = py - effectY[e];
+      if (effectType[e] == type && dx * dx + dy * dy <= SKILL_RADIUS * SKILL_RADIUS) return true;
+    }
+    return false;
+  }
+
+  void thrust(int i, float tx, float ty, float power) {
+    float dx = tx - x[i], dy = ty - y[i];
+    float d  = sqrtf(dx * dx + dy * dy);
+    if (d < EPSILON) return;
+    float coef = power / (effectiveMass[i] * d);
+    vx[i] += dx * coef;
+    vy[i] += dy * coef;
+  }
+
+  // Earliest time in [0, limit) at which bodies i and j touch, or limit if they do not
+  float collisionTime(int i, int j, float limit) {
+    float dx = x[j] - x[i], dy = y[j] - y[i];
+    float dvx = vx[j] - vx[i], dvy = vy[j] - vy[i];
+    float r   = radius[i] + radius[j];
+    float b   = dx * dvx + dy * dvy;
+    if (b >= 0) return limit;  // moving apart
+    float a = dvx * dvx + dvy * dvy;
+    float c = dx * dx + dy * dy - r * r;
+    if (c <= 0) return 0;  // already overlapping and closing in
+    float delta = b * b - a * c;
+    if (delta < 0) return limit;
+    float t = (-b - sqrtf(delta)) / a;
+    return t < limit ? t : limit;
+  }
+  // Earliest collision between a looter i and a body j > i before limit, skipping the pair (lastI, lastJ) that was
+  // just resolved: limit if there is none, else its time with ci, cj set. Scalar reference of firstCollision.
+  float firstCollisionScalar(float limit, int lastI, int lastJ, int &ci, int &cj) {
+    for (int i = 0; i < min(NB_LOOTER, nbBody); i++) {
+      for (int j = i + 1; j < nbBody; j++) {
+        if (i == lastI && j == lastJ) continue;
+        float tc = collisionTime(i, j, limit);
+        if (tc < limit) {
+          limit = tc;
+          ci    = i;
+          cj    = j;
+        }
+      }
+    }
+    return limit;
+  }
+
+  // Same as firstCollisionScalar, 8 bodies j at a time. Each lane keeps its earliest time and pair (as 32 * i + j,
+  // in scan order so that ties go to the first pair like in the scalar loop), lanes are reduced once at the end.
+  // Lanes past nbBody read stale slots and are masked out.
+  float firstCollision(float limit, int lastI, int lastJ, int &ci, int &cj) {
+    const __m256 lane  = _mm256_setr_ps(0, 1, 2, 3, 4, 5, 6, 7);
+    const __m256 zero  = _mm256_setzero_ps();
+    const __m256 bound = _mm256_set1_ps((float)nbBody);
+    __m256       best = _mm256_set1_ps(limit), bestPair = _mm256_set1_ps(-1.0f);
+    for (int i = 0; i < min(NB_LOOTER, nbBody); i++) {
+      __m256 xi = _mm256_set1_ps(x[i]), yi = _mm256_set1_ps(y[i]);
+      __m256 vxi = _mm256_set1_ps(vx[i]), vyi = _mm256_set1_ps(vy[i]), ri = _mm256_set1_ps(radius[i]);
+      __m256 fi = _mm256_set1_ps((float)i), skip = _mm256_set1_ps(i == lastI ? (float)lastJ : -1.0f);
+      for (int j0 = (i + 1) & ~7; j0 < nbBody; j0 += 8) {
+        __m256 dx    = _mm256_sub_ps(_mm256_loadu_ps(x + j0), xi);
+        __m256 dy    = _mm256_sub_ps(_mm256_loadu_ps(y + j0), yi);
+        __m256 dvx   = _mm256_sub_ps(_mm256_loadu_ps(vx + j0), vxi);
+        __m256 dvy   = _mm256_sub_ps(_mm256_loadu_ps(vy + j0), vyi);
+        __m256 r     = _mm256_add_ps(_mm256_loadu_ps(radius + j0), ri);
+        __m256 b     = _mm256_add_ps(_mm256_mul_ps(dx, dvx), _mm256_mul_ps(dy, dvy));
+        __m256 a     = _mm256_add_ps(_mm256_mul_ps(dvx, dvx), _mm256_mul_ps(dvy, dvy));
+        __m256 c     = _mm256_sub_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)), _mm256_mul_ps(r, r));
+        __m256 delta = _mm256_sub_ps(_mm256_mul_ps(b, b), _mm256_mul_ps(a, c));
+        // lanes without a collision: moving apart, missing each other, j <= i, j >= nbBody, the last pair
+        __m256 overlapping = _mm256_cmp_ps(c, zero, _CMP_LE_OQ);
+        __m256 j           = _mm256_add_ps(lane, _mm256_set1_ps((float)j0));
+        __m256 none        = _mm256_cmp_ps(b, zero, _CMP_GE_OQ);
+        none = _mm256_or_ps(none, _mm256_andnot_ps(overlapping, _mm256_cmp_ps(delta, zero, _CMP_LT_OQ)));
+        none = _mm256_or_ps(none, _mm256_cmp_ps(j, fi, _CMP_LE_OQ));
+        none = _mm256_or_ps(none, _mm256_cmp_ps(j, bound, _CMP_GE_OQ));
+        none = _mm256_or_ps(none, _mm256_cmp_ps(j, skip, _CMP_EQ_OQ));
+        if (_mm256_movemask_ps(none) == 0xFF) continue;  // most chunks, spares the sqrt and the division
+        __m256 t = _mm256_div_ps(_mm256_sub_ps(_mm256_sub_ps(zero, b), _mm256_sqrt_ps(_mm256_max_ps(delta, zero))), a);
+        t        = _mm256_blendv_ps(t, zero, overlapping);
+        __m256 earlier = _mm256_andnot_ps(none, _mm256_cmp_ps(t, best, _CMP_LT_OQ));
+        best           = _mm256_blendv_ps(best, t, earlier);
+        bestPair = _mm256_blendv_ps(bestPair, _mm256_add_ps(_mm256_mul_ps(fi, _mm256_set1_ps(32.0f)), j), earlier);
+      }
+    }
+    float times[8], pairs[8];
+    _mm256_storeu_ps(times, best);
+    _mm256_storeu_ps(pairs, bestPair);
+    int k = -1;
+    for (int l = 0; l < 8; l++) {
+      if (pairs[l] >= 0 && (k == -1 || times[l] < times[k] || (times[l] == times[k] && pairs[l] < pairs[k]))) k = l;
+    }
+    if (k == -1) return limit;
+    ci = (int)pairs[k] / 32;
+    cj = (int)pairs[k] % 32;
+    return times[k];
+  }
+
+  // Earliest time in [0, limit) at which looter i hits the border of the map, or limit
+  float borderTime(int i, float limit) {
+    float b = x[i] * vx[i] + y[i] * vy[i];
+    if (b <= 0) return limit;  // heading inwards
+    float a = vx[i] * vx[i] + vy[i] * vy[i];
+    float r = MAP_RADIUS - radius[i];
+    float c = x[i] * x[i] + y[i] * y[i] - r * r;
+    if (c >= 0) return 0;
+    float t = (-b + sqrtf(b * b - a * c)) / a;
+    return t < limit ? t : limit;
+  }
+
+  // Half of the elastic impulse is applied as is, the other half is raised to MIN_IMPULSE at least
+  static float impulseScale(float fx, float fy) {
+    float impulse = sqrtf(fx * fx + fy * fy);
+    return 1.0f + (impulse < MIN_IMPULSE && impulse > EPSILON ? MIN_IMPULSE / impulse : 1.0f);
+  }
+  void bounce(int i, int j) {
+    float m1 = effectiveMass[i], m2 = effectiveMass[j];
+    float nx = x[i] - x[j], ny = y[i] - y[j];
+    float d2 = nx * nx + ny * ny;
+    if (d2 < EPSILON) return;
+    float product = (nx * (vx[i] - vx[j]) + ny * (vy[i] - vy[j])) * m1 * m2 / ((m1 + m2) * d2);
+    float fx = nx * product, fy = ny * product;
+    float scale = impulseScale(fx, fy);
+    vx[i] -= fx * scale / m1;
+    vy[i] -= fy * scale / m1;
+    vx[j] += fx * scale / m2;
+    vy[j] += fy * scale / m2;
+  }
+  // the border of the map behaves as a body of infinite mass
+  void bounceBorder(int i) {
+    float nx = x[i], ny = y[i];
+    float product = (nx * vx[i] + ny * vy[i]) / (nx * nx + ny * ny);
+    float fx = nx * product, fy = ny * product;
+    float scale = impulseScale(fx, fy);
+    vx[i] -= fx * scale;
+    vy[i] -= fy * scale;
+  }
+
+  void advance(float t) {
+    for (int i = 0; i < nbBody; i++) {
+      x[i] += vx[i] * t;
+      y[i] += vy[i] * t;
+    }
+  }
+
+  // Move all bodies for one turn, resolving collisions in chronological order
+  void move() {
+    float t     = 0;
+    int   lastI = -1, lastJ = -1;
+    for (int k = 0; t < 1.0f; k++) {
+      if (k == MAX_COLLISIONS) {  // bodies stuck against each other, let them overlap
+        advance(1.0f - t);
+        break;
+      }
+      float first = 1.0f - t;
+      int   ci = -1, cj = -1;
+      for (int i = 0; i < min(NB_LOOTER, nbBody); i++) {
+        if (lastI == i && lastJ == -1) continue;
+        float tb = borderTime(i, first);
+        if (tb < first) {
+          first = tb;
+          ci    = i;
+          cj    = -1;
+        }
+      }
+      first = firstCollision(first, lastI, lastJ, ci, cj);  // tankers do not push each other
+      advance(first);
+      t += first;
+      if (ci == -1) break;
+      if (cj == -1) {
+        bounceBorder(ci);
+      } else if (ci % 3 == DESTROYER && ci < NB_LOOTER && cj >= NB_LOOTER) {
+        destroyTanker(cj);
+        ci = cj = -1;  // slot cj now holds another tanker, which the destroyer may meet right away
+      } else {
+        bounce(ci, cj);
+      }
+      lastI = ci;
+      lastJ = cj;
+    }
+  }
+
+  // Play one turn with the given orders of the NB_LOOTER looters
+  void step(const Order *orders) {
+    // skills
+    for (int i = 0; i < NB_LOOTER; i++) {
+      const Order &o = orders[i];
+      if (!o.skill) continue;
+      int   player = i / 3, type = i % 3;
+      int   cost   = (type == REAPER ? TAR_COST : (type == DESTROYER ? GRENADE_COST : OIL_COST));
+      float dx = o.x - x[i], dy = o.y - y[i];
+      if (rage[player] < cost || dx * dx + dy * dy > SKILL_RANGE * SKILL_RANGE) continue;
+      rage[player] -= cost;
+      if (type == REAPER) addEffect(TAR, o.x, o.y, TAR_DURATION);
+      if (type == DESTROYER) addEffect(GRENADE, o.x, o.y, GRENADE_DURATION);
+      if (type == DOOF) addEffect(OIL, o.x, o.y, OIL_DURATION);
+    }
+    // tar makes bodies heavier, grenades push them away
+    for (int i = 0; i < nbBody; i++) {
+      effectiveMass[i] = mass[i] + (inEffect(TAR, x[i], y[i]) ? TAR_MASS_BONUS : 0.0f);
+    }
+    for (int e = 0; e < nbEffect; e++) {
+      if (effectType[e] != GRENADE) continue;
+      for (int i = 0; i < nbBody; i++) {
+        float dx = x[i] - effectX[e], dy = y[i] - effectY[e];
+        if (dx * dx + dy * dy <= SKILL_RADIUS * SKILL_RADIUS) thrust(i, effectX[e], effectY[e], -GRENADE_POWER);
+      }
+    }
+    // thrusts
+    for (int i = 0; i < NB_LOOTER; i++) {
+      if (!orders[i].skill && orders[i].thrust > 0) thrust(i, orders[i].x, orders[i].y, min(orders[i].thrust, MAX_THRUST));
+    }
+    for (int i = NB_LOOTER; i < nbBody; i++) {
+      thrust(i, 0, 0, water[i] < capacity[i] ? TANKER_THRUST : -TANKER_THRUST);
+    }
+
+    move();
+
+    // rage from the doofs' speed, then friction and rounding
+    for (int p = 0; p < NB_PLAYER; p++) {
+      int i   = looter(p, DOOF);
+      rage[p] = min(MAX_RAGE, rage[p] + (int)(sqrtf(vx[i] * vx[i] + vy[i] * vy[i]) * DOOF_RAGE_COEF));
+    }
+    for (int i = 0; i < nbBody; i++) {
+      x[i]  = roundf(x[i]);
+      y[i]  = roundf(y[i]);
+      vx[i] = roundf(vx[i] * (1.0f - friction[i]));
+      vy[i] = roundf(vy[i] * (1.0f - friction[i]));
+    }
+
+    // tankers fill up in the water town and leave the map once full
+    for (int i = NB_LOOTER; i < nbBody; i++) {
+      float d2 = x[i] * x[i] + y[i] * y[i];
+      if (water[i] < capacity[i] && d2 <= WATER_TOWN_RADIUS * WATER_TOWN_RADIUS) {
+        water[i]++;
+        mass[i] += TANKER_MASS_BY_WATER;
+      } else if (water[i] >= capacity[i] && d2 > (MAP_RADIUS + radius[i]) * (MAP_RADIUS + radius[i])) {
+        removeTanker(i--);
+      }
+    }
+
+    // reapers harvest every wreck they are on, unless covered in oil: each of them scores, and the wreck loses a
+    // single water however many reapers it feeds
+    bool oiled[NB_PLAYER];
+    for (int p = 0; p < NB_PLAYER; p++) oiled[p] = inEffect(OIL, x[looter(p, REAPER)], y[looter(p, REAPER)]);
+    for (int w = 0; w < nbWreck; w++) {
+      if (wreckWater[w] <= 0) continue;
+      int harvesters = 0;
+      for (int p = 0; p < NB_PLAYER; p++) {
+        int   i  = looter(p, REAPER);
+        float dx = x[i] - wreckX[w], dy = y[i] - wreckY[w];
+        if (oiled[p] || dx * dx + dy * dy > wreckRadius[w] * wreckRadius[w]) continue;
+        score[p]++;
+        harvesters++;
+      }
+      if (harvesters > 0) wreckWater[w]--;
+    }
+    for (int w = 0; w < nbWreck; w++) {
+      if (wreckWater[w] > 0) continue;
+      nbWreck--;
+      wreckX[w]      = wreckX[nbWreck];
+      wreckY[w]      = wreckY[nbWreck];
+      wreckRadius[w] = wreckRadius[nbWreck];
+      wreckId[w]     = wreckId[nbWreck];
+      wreckWater[w]  = wreckWater[nbWreck];
+      w--;
+    }
+
+    for (int e = 0; e < nbEffect; e++) {
+      if (--effectDuration[e] > 0) continue;
+      nbEffect--;
+      effectX[e]        = effectX[nbEffect];
+      effectY[e]        = effectY[nbEffect];
+      effectType[e]     = effectType[nbEffect];
+      effectDuration[e] = effectDuration[nbEffect];
+      e--;
+    }
+    turn++;
+  }
+
+  // Play `turns` turns, asking policy(simulation, orders) for the orders of every turn
+  template <typename policy_function>
+  void rollout(int turns, policy_function &&policy) {
+    Order orders[NB_LOOTER];
+    for (int k = 0; k < turns; k++) {
+      policy(*this, orders);
+      step(orders);
+    }
+  }
+
+  void load(const UnitTable &table, int *scores, int *rages) {
+    *this = Simulation();
+    for (int p = 0; p < NB_PLAYER; p++) {
+      score[p] = scores[p];
+      rage[p]  = rages[p];
+    }
+    for (int i = 0; i < table.count; i++) {
+      const Unit &u = table.units[i];
+      if (u.type <= DOOF) {
+        setLooter(looter(u.playerId, u.type), u.id, u.loc.first, u.loc.second, u.speed.first, u.speed.second);
+      } else if (u.type == TANKER) {
+        addTanker(u.id, u.loc.first, u.loc.second, u.speed.first, u.speed.second, u.nbWater, u.waterCapacity,
+                  u.radius);
+      } else if (u.type == WRECK) {
+        addWreck(u.id, u.loc.first, u.loc.second, u.radius, u.nbWater);
+      } else if (u.type == TAR || u.type == OIL) {
+        addEffect(u.type, u.loc.first, u.loc.second, u.nbWater);
+      }
+    }
+  }
+};
+
+// Uniform grid over every unit of a simulation, rebuilt each turn with a counting sort. Entries are stored cell by
+// cell, an entry knows the type of its unit and its index in the simulation arrays (body, wreck or effect index).
+// Queries take a mask of unit types (1 << TANKER, ...) and write entry numbers to `out`.
+struct SpatialIndex {
+  int   nbEntry;
+  float x[MAX_INDEXED], y[MAX_INDEXED];
+  int   type[MAX_INDEXED], ref[MAX_INDEXED];
+  int   cellStart[GRID_SIZE * GRID_SIZE + 1];
+
+  SpatialIndex() : nbEntry(0) { fill(cellStart, cellStart + GRID_SIZE * GRID_SIZE + 1, 0); }
+
+  static int cellOf(float c) { return min(GRID_SIZE - 1, max(0, (int)floorf(c / GRID_CELL) + GRID_SIZE / 2)); }
+
+  void build(const Simulation &sim) {
+    int   cell[MAX_INDEXED], srcType[MAX_INDEXED], srcRef[MAX_INDEXED];
+    float srcX[MAX_INDEXED], srcY[MAX_INDEXED];
+    int   n    = 0;
+    auto  push = [&](float px, float py, int t, int r) {
+      srcX[n]    = px;
+      srcY[n]    = py;
+      srcType[n] = t;
+      srcRef[n]  = r;
+      cell[n++]  = cellOf(py) * GRID_SIZE + cellOf(px);
+    };
+    for (int i = 0; i < sim.nbBody; i++) {
+      if (sim.id[i] != -1) push(sim.x[i], sim.y[i], i < NB_LOOTER ? i % 3 : TANKER, i);
+    }
+    for (int w = 0; w < sim.nbWreck; w++) push(sim.wreckX[w], sim.wreckY[w], WRECK, w);
+    for (int e = 0; e < sim.nbEffect; e++) push(sim.effectX[e], sim.effectY[e], sim.effectType[e], e);
+
+    fill(cellStart, cellStart + GRID_SIZE * GRID_SIZE + 1, 0);
+    for (int i = 0; i < n; i++) cellStart[cell[i] + 1]++;
+    for (int c = 0; c < GRID_SIZE * GRID_SIZE; c++) cellStart[c + 1] += cellStart[c];
+    int next[GRID_SIZE * GRID_SIZE];
+    copy(cellStart, cellStart + GRID_SIZE * GRID_SIZE, next);
+    for (int i = 0; i < n; i++) {
+      int j   = next[cell[i]]++;
+      x[j]    = srcX[i];
+      y[j]    = srcY[i];
+      type[j] = srcType[i];
+      ref[j]  = srcRef[i];
+    }
+    nbEntry = n;
+  }
+
+  // Entries of the given types whose center is within r of (px, py), returns how many were written (at most maxOut)
+  int radius(float px, float py, float r, int typeMask, int *out, int maxOut) const {
+    int   n  = 0;
+    float r2 = r * r;
+    int   x0 = cellOf(px - r), x1 = cellOf(px + r), y0 = cellOf(py - r), y1 = cellOf(py + r);
+    for (int cy = y0; cy <= y1; cy++) {
+      for (int j = cellStart[cy * GRID_SIZE + x0]; j < cellStart[cy * GRID_SIZE + x1 + 1]; j++) {
+        if (!(typeMask >> type[j] & 1)) continue;
+        float dx = x[j] - px, dy = y[j] - py;
+        if (dx * dx + dy * dy <= r2 && n < maxOut) out[n++] = j;
+      }
+    }
+    return n;
+  }
+
+  // Lower bound of the squared distance from (px, py), in cell (qx, qy), to the entries of the rings >= ring: the
+  // distance to the closest side of the block of the inner rings that still has cells beyond it
+  static float ringDistance(float px, float py, int qx, int qy, int ring) {
+    if (ring == 0) return -1;
+    float d = 1e18f;
+    if (qx - ring >= 0) d = min(d, px - (qx - ring + 1 - GRID_SIZE / 2) * GRID_CELL);
+    if (qx + ring < GRID_SIZE) d = min(d, (qx + ring - GRID_SIZE / 2) * GRID_CELL - px);
+    if (qy - ring >= 0) d = min(d, py - (qy - ring + 1 - GRID_SIZE / 2) * GRID_CELL);
+    if (qy + ring < GRID_SIZE) d = min(d, (qy + ring - GRID_SIZE / 2) * GRID_CELL - py);
+    return d < 0 ? -1 : d * d;
+  }
+
+  // The k entries of the given types closest to (px, py), closest first, returns how many were found. Rings of cells
+  // are visited outwards until the k-th best distance is below the distance to the next ring.
+  int nearest(float px, float py, int typeMask, int k, int *out) const {
+    float dist[MAX_INDEXED];
+    int   n  = 0;
+    k        = min(k, MAX_INDEXED);
+    if (k <= 0) return 0;
+    int   qx = cellOf(px), qy = cellOf(py);
+    for (int ring = 0; ring < GRID_SIZE; ring++) {
+      if (n == k && dist[k - 1] <= ringDistance(px, py, qx, qy, ring)) break;
+      for (int cy = max(0, qy - ring); cy <= min(GRID_SIZE - 1, qy + ring); cy++) {
+        bool edge = (cy == qy - ring || cy == qy + ring);
+        int  step = (edge ? 1 : 2 * ring);
+        for (int cx = qx - ring; cx <= qx + ring; cx += step) {
+          if (cx < 0 || cx >= GRID_SIZE) continue;
+          for (int j = cellStart[cy * GRID_SIZE + cx]; j < cellStart[cy * GRID_SIZE + cx + 1]; j++) {
+            if (!(typeMask >> type[j] & 1)) continue;
+            float dx = x[j] - px, dy = y[j] - py, d = dx * dx + dy * dy;
+            if (n == k && d >= dist[k - 1]) continue;
+            int i = (n < k ? n++ : k - 1);
+            for (; i > 0 && dist[i - 1] > d; i--) {
+              dist[i] = dist[i - 1];
+              out[i]  = out[i - 1];
+            }
+            dist[i] = d;
+            out[i]  = j;
+          }
+        }
+      }
+    }
+    return n;
+  }
+};
+
+// xorshift32, enough for mutations and far cheaper than <random>. One state per thread, must not be 0.
+static thread_local uint32_t rngState = 2463534242u;
+inline uint32_t fastRand() {
+  rngState ^= rngState << 13;
+  rngState ^= rngState >> 17;
+  rngState ^= rngState << 5;
+  return rngState;
+}
+inline float randFloat() { return fastRand() * (1.0f / 4294967296.0f); }
+
+int closestWreck(Simulation &sim, int i) {
+  int   best  = -1;
+  float bestD = 1e18f;
+  for (int w = 0; w < sim.nbWreck; w++) {
+    float dx = sim.wreckX[w] - sim.x[i], dy = sim.wreckY[w] - sim.y[i];
+    if (dx * dx + dy * dy < bestD) {
+      bestD = dx * dx + dy * dy;
+      best  = w;
+    }
+  }
+  return best;
+}
+int closestTanker(Simulation &sim, int i) {
+  int   best  = -1;
+  float bestD = 1e18f;
+  for (int t = NB_LOOTER; t < sim.nbBody; t++) {
+    float dx = sim.x[t] - sim.x[i], dy = sim.y[t] - sim.y[i];
+    if (dx * dx + dy * dy < bestD) {
+      bestD = dx * dx + dy * dy;
+      best  = t;
+    }
+  }
+  return best;
+}
+// A body that keeps accelerating by (ax, ay) every turn. With r = 1 - friction, after n turns it has moved by
+// v * S(n) + a * C(n), where S(n) = 1 + r + ... + r^(n-1) and C(n) = S(1) + ... + S(n).
+struct Trajectory {
+  float x, y, vx, vy, friction, ax, ay;
+  Trajectory(float px, float py, float pvx = 0, float pvy = 0, float f = 0, float pax = 0, float pay = 0)
+      : x(px), y(py), vx(pvx), vy(pvy), friction(f), ax(pax), ay(pay) {}
+};
+
+// The order reaching the target soonest
+struct Intercept {
+  Order order;
+  int   turns;  // turns until the mover is within reach of the target, -1 beyond INTERCEPT_HORIZON
+};
+
+// Fewest turns n for which the target lies in the disk a body can reach at full thrust in a fixed direction, then the
+// direction from where the body drifts to where the target will be, and just the thrust needed to get there at turn
+// n rather than overshoot. Collisions and rounding are ignored.
+Intercept intercept(float x, float y, float vx, float vy, float mass, float friction, const Trajectory &target,
+                    float reach) {
+  float r = 1.0f - friction, rt = 1.0f - target.friction, acc = MAX_THRUST / mass;
+  float pw = 1, s = 0, c = 0, pwt = 1, st = 0, ct = 0;
+  float dx = 0, dy = 0, d = 0;
+  int   n  = 1;
+  for (; n <= INTERCEPT_HORIZON; n++) {
+    s += pw;
+    pw *= r;
+    c += s;
+    st += pwt;
+    pwt *= rt;
+    ct += st;
+    dx = target.x + target.vx * st + target.ax * ct - (x + vx * s);
+    dy = target.y + target.vy * st + target.ay * ct - (y + vy * s);
+    d  = sqrtf(dx * dx + dy * dy);
+    if (d - reach <= acc * c) break;
+  }
+  if (n == 1) {
+    // within reach this turn: land on the point of the inner half of the target closest to where the body is now,
+    // which leaves it with the least speed to drift out
+    float tx = dx + x + vx, ty = dy + y + vy;
+    float ox = x - tx, oy = y - ty, o = sqrtf(ox * ox + oy * oy);
+    float k  = (o > EPSILON ? min(o, reach / 2) / o : 0.0f);
+    dx       = tx + ox * k - (x + vx);
+    dy       = ty + oy * k - (y + vy);
+    d        = sqrtf(dx * dx + dy * dy);
+  }
+  Intercept result;
+  result.turns = (n > INTERCEPT_HORIZON ? -1 : n);
+  if (d < EPSILON) return result;
+  int thrust   = (n > INTERCEPT_HORIZON ? MAX_THRUST : min(MAX_THRUST, (int)ceilf(d * mass / c)));
+  result.order = Order(x + dx / d * ORDER_DISTANCE, y + dy / d * ORDER_DISTANCE, thrust);
+  return result;
+}
+
+// Trajectory of a body of the simulation: tankers keep thrusting towards the center until full, then away from it
+Trajectory trajectory(Simulation &sim, int i) {
+  float ax = 0, ay = 0, d = sqrtf(sim.x[i] * sim.x[i] + sim.y[i] * sim.y[i]);
+  if (i >= NB_LOOTER && d > EPSILON) {
+    float coef = (sim.water[i] < sim.capacity[i] ? -TANKER_THRUST : TANKER_THRUST) / (sim.mass[i] * d);
+    ax         = sim.x[i] * coef;
+    ay         = sim.y[i] * coef;
+  }
+  return Trajectory(sim.x[i], sim.y[i], sim.vx[i], sim.vy[i], sim.friction[i], ax, ay);
+}
+Intercept intercept(Simulation &sim, int i, const Trajectory &target, float reach) {
+  float mass = sim.mass[i] + (sim.inEffect(TAR, sim.x[i], sim.y[i]) ? TAR_MASS_BONUS : 0.0f);
+  return intercept(sim.x[i], sim.y[i], sim.vx[i], sim.vy[i], mass, sim.friction[i], target, reach);
+}
+
+int bestEnemy(Simulation &sim, int player) {
+  int e1 = (player + 1) % NB_PLAYER, e2 = (player + 2) % NB_PLAYER;
+  return sim.score[e1] >= sim.score[e2] ? e1 : e2;
+}
+
+// The hand-written rules: reapers go to the closest wreck (else the closest tanker), destroyers to the closest
+// tanker and doofs chase the reaper of the leading enemy. Either aiming at the target minus the current speed, or
+// following the intercept planner when `planned`.
+void heuristicOrders(Simulation &sim, int player, Order *orders, bool planned = false) {
+  int  reaper = Simulation::looter(player, REAPER), destroyer = Simulation::looter(player, DESTROYER);
+  int  doof   = Simulation::looter(player, DOOF);
+  auto goTo   = [&](int i, const Trajectory &target, float reach) {
+    if (planned) return intercept(sim, i, target, reach).order;
+    return Order(target.x - sim.vx[i], target.y - sim.vy[i], MAX_THRUST);
+  };
+  int wreck = closestWreck(sim, reaper), tanker = closestTanker(sim, reaper);
+  if (wreck != -1) {
+    orders[reaper] = goTo(reaper, Trajectory(sim.wreckX[wreck], sim.wreckY[wreck]), sim.wreckRadius[wreck]);
+  } else if (tanker != -1) {
+    orders[reaper] = goTo(reaper, trajectory(sim, tanker), sim.radius[tanker]);
+  } else {
+    orders[reaper] = Order();
+  }
+  tanker = closestTanker(sim, destroyer);
+  if (tanker != -1) {
+    orders[destroyer] = goTo(destroyer, trajectory(sim, tanker), sim.radius[tanker] + sim.radius[destroyer]);
+  } else {
+    orders[destroyer] = Order();
+  }
+  int target   = Simulation::looter(bestEnemy(sim, player), REAPER);
+  orders[doof] = goTo(doof, trajectory(sim, target), sim.radius[target] + sim.radius[doof]);
+}
+
+// Default fitness: water first, then rage and how well the looters are placed for the turns after the horizon
+struct DefaultFitness {
+  float operator()(Simulation &sim) {
+    int   reaper = Simulation::looter(0, REAPER), destroyer = Simulation::looter(0, DESTROYER);
+    int   doof   = Simulation::looter(0, DOOF);
+    float f      = 100.0f * sim.score[0] - 50.0f * sim.score[bestEnemy(sim, 0)] + 0.5f * sim.rage[0];
+    int   wreck  = closestWreck(sim, reaper);
+    if (wreck != -1) f -= hypotf(sim.wreckX[wreck] - sim.x[reaper], sim.wreckY[wreck] - sim.y[reaper]) / 100.0f;
+    int tanker = closestTanker(sim, destroyer);
+    if (tanker != -1) f -= hypotf(sim.x[tanker] - sim.x[destroyer], sim.y[tanker] - sim.y[destroyer]) / 200.0f;
+    int target = Simulation::looter(bestEnemy(sim, 0), REAPER);
+    f -= hypotf(sim.x[target] - sim.x[doof], sim.y[target] - sim.y[doof]) / 400.0f;
+    return f;
+  }
+};
+
+// SEARCH_DEPTH turns of (angle, thrust) for our three looters
+struct Genome {
+  float angle[SEARCH_DEPTH][3];
+  int   thrust[SEARCH_DEPTH][3];
+  float fitness;
+
+  Order order(Simulation &sim, int turn, int type) {
+    int i = Simulation::looter(0, type);
+    return Order(sim.x[i] + ORDER_DISTANCE * cosf(angle[turn][type]),
+                 sim.y[i] + ORDER_DISTANCE * sinf(angle[turn][type]), thrust[turn][type]);
+  }
+  void set(Simulation &sim, int turn, int type, const Order &o) {
+    int i               = Simulation::looter(0, type);
+    angle[turn][type]   = atan2f(o.y - sim.y[i], o.x - sim.x[i]);
+    thrust[turn][type]  = o.thrust;
+  }
+  void randomize(int turn, int type) {
+    angle[turn][type]  = randFloat() * 2 * M_PI;
+    thrust[turn][type] = (fastRand() & 1) ? MAX_THRUST : fastRand() % (MAX_THRUST + 1);
+  }
+  void mutate() {
+    int turn = fastRand() % SEARCH_DEPTH, type = fastRand() % 3;
+    if (fastRand() % 4 == 0) {
+      randomize(turn, type);
+    } else {
+      angle[turn][type] += (randFloat() - 0.5f) * (M_PI / 2);
+      thrust[turn][type] = max(0, min(MAX_THRUST, thrust[turn][type] + (int)((randFloat() - 0.5f) * 200)));
+    }
+  }
+  // next turn's plan: drop the turn that was just played and extend the last one
+  void shift() {
+    for (int k = 0; k + 1 < SEARCH_DEPTH; k++) {
+      for (int t = 0; t < 3; t++) {
+        angle[k][t]  = angle[k + 1][t];
+        thrust[k][t] = thrust[k + 1][t];
+      }
+    }
+  }
+};
+
+enum policyType { RULES_POLICY, PLANNED_POLICY, COAST_POLICY, POLICY_MAX };
+static const string policy2str[] = {"rules", "planned", "coast"};
+
+// Model of the enemy looters. Each turn the position of every enemy looter one turn ahead is predicted under each
+// candidate policy, and checked against where it shows up the next turn. Every looter then follows the policy that
+// predicted it best so far. The orders of the enemies along the SEARCH_DEPTH turns to come are played out once per
+// turn and cached, so that the searches replay them instead of running the enemy policy in every rollout.
+struct OpponentModel {
+  int   policy[NB_LOOTER];
+  float error[NB_LOOTER][POLICY_MAX];  // moving average of the distance between predicted and observed positions
+  int   hits[NB_LOOTER][POLICY_MAX], predictions[NB_LOOTER];
+  float predictedX[POLICY_MAX][NB_LOOTER], predictedY[POLICY_MAX][NB_LOOTER];
+  bool  pending;
+  Order trajectory[SEARCH_DEPTH][NB_LOOTER];
+
+  OpponentModel() : pending(false) {
+    for (int i = 0; i < NB_LOOTER; i++) {
+      policy[i]      = RULES_POLICY;
+      predictions[i] = 0;
+      for (int q = 0; q < POLICY_MAX; q++) {
+        error[i][q] = 0;
+        hits[i][q]  = 0;
+      }
+    }
+  }
+
+  static void policyOrders(Simulation &sim, int player, int policy, Order *orders) {
+    if (policy == COAST_POLICY) {
+      for (int t = 0; t < 3; t++) orders[Simulation::looter(player, t)] = Order();
+    } else {
+      heuristicOrders(sim, player, orders, policy == PLANNED_POLICY);
+    }
+  }
+  // Orders of the enemy looters, each on its own policy
+  void orders(Simulation &sim, Order *orders) const {
+    Order byPolicy[POLICY_MAX][NB_LOOTER];
+    for (int p = 1; p < NB_PLAYER; p++) {
+      bool used[POLICY_MAX] = {false};
+      for (int t = 0; t < 3; t++) {
+        int i = Simulation::looter(p, t);
+        if (!used[policy[i]]) policyOrders(sim, p, policy[i], byPolicy[policy[i]]);
+        used[policy[i]] = true;
+        orders[i]       = byPolicy[policy[i]][i];
+      }
+    }
+  }
+
+  // Score last turn's predictions against the positions of this turn
+  void observe(Simulation &sim) {
+    if (!pending) return;
+    for (int i = 3; i < NB_LOOTER; i++) {
+      predictions[i]++;
+      for (int q = 0; q < POLICY_MAX; q++) {
+        float e = hypotf(predictedX[q][i] - sim.x[i], predictedY[q][i] - sim.y[i]);
+        error[i][q] += (predictions[i] == 1 ? 1.0f : OPPONENT_EMA) * (e - error[i][q]);
+        hits[i][q] += (e <= PREDICTION_TOLERANCE);
+      }
+      policy[i] = min_element(error[i], error[i] + POLICY_MAX) - error[i];
+    }
+    pending = false;
+  }
+
+  // Predict next turn's positions under every policy, given the orders we play this turn. The looters of one enemy
+  // follow the policy tried while the other enemy keeps its current model.
+  void predict(Simulation &root, const Order *ours) {
+    Order model[NB_LOOTER], played[NB_LOOTER];
+    orders(root, model);
+    for (int q = 0; q < POLICY_MAX; q++) {
+      for (int p = 1; p < NB_PLAYER; p++) {
+        Simulation sim = root;
+        copy(model, model + NB_LOOTER, played);
+        copy(ours, ours + 3, played);
+        policyOrders(sim, p, q, played);
+        sim.step(played);
+        for (int t = 0; t < 3; t++) {
+          int i            = Simulation::looter(p, t);
+          predictedX[q][i] = sim.x[i];
+          predictedY[q][i] = sim.y[i];
+        }
+      }
+    }
+    pending = true;
+  }
+
+  // Cache the enemy orders of the turns to come, our looters following the planned rules
+  void cache(Simulation &root) {
+    Simulation sim = root;
+    for (int k = 0; k < SEARCH_DEPTH; k++) {
+      heuristicOrders(sim, 0, trajectory[k], true);
+      orders(sim, trajectory[k]);
+      sim.step(trajectory[k]);
+    }
+  }
+
+  // Hit rate of the policy followed by looter i
+  float accuracy(int i) const { return predictions[i] ? (float)hits[i][policy[i]] / predictions[i] : 0.0f; }
+};
+
+// Enemy orders of turn k of a rollout: cached by the model when there is one, else the rules
+void enemyOrders(const OpponentModel *model, Simulation &sim, int k, Order *orders) {
+  if (model) {
+    for (int i = 3; i < NB_LOOTER; i++) orders[i] = model->trajectory[k][i];
+  } else {
+    for (int p = 1; p < NB_PLAYER; p++) heuristicOrders(sim, p, orders);
+  }
+}
+
+// Rolling horizon evolution: a population of plans is evaluated by simulating SEARCH_DEPTH turns (the enemies
+// following heuristicOrders), then improved by crossover and mutation until the deadline. The best plan of a turn,
+// shifted by one turn, seeds the next search. Parents and children live in one preallocated array.
+template <typename fitness_function = DefaultFitness>
+struct Evolution {
+  Genome           pool[2 * POPULATION];
+  Genome          *parents[2 * POPULATION];
+  bool                 warm;
+  int                  generations, evaluations;
+  fitness_function     fitness;
+  const OpponentModel *opponents;  // enemy orders of the rollouts, the rules when null
+  int                  maxGenerations;
+
+  Evolution() : warm(false), generations(0), evaluations(0), opponents(nullptr), maxGenerations(INT_MAX) {
+    for (int g = 0; g < 2 * POPULATION; g++) parents[g] = &pool[g];
+  }
+
+  void evaluate(Simulation &root, Genome &g) {
+    Simulation sim = root;
+    Order      orders[NB_LOOTER];
+    for (int k = 0; k < SEARCH_DEPTH; k++) {
+      for (int t = 0; t < 3; t++) orders[t] = g.order(sim, k, t);
+      enemyOrders(opponents, sim, k, orders);
+      sim.step(orders);
+    }
+    g.fitness = fitness(sim);
+    evaluations++;
+  }
+
+  Genome &search(Simulation &root, time_point<high_resolution_clock> deadline) {
+    generations = evaluations = 0;
+    // seeds: last turn's best plan, the hand-written rules played out with the planner, then random plans
+    Genome     &rules = *parents[warm ? 1 : 0];
+    Simulation  sim   = root;
+    Order       orders[NB_LOOTER];
+    for (int k = 0; k < SEARCH_DEPTH; k++) {
+      heuristicOrders(sim, 0, orders, true);
+      enemyOrders(opponents, sim, k, orders);
+      for (int t = 0; t < 3; t++) rules.set(sim, k, t, orders[t]);
+      sim.step(orders);
+    }
+    for (int g = (warm ? 2 : 1); g < POPULATION; g++) {
+      for (int k = 0; k < SEARCH_DEPTH; k++) {
+        for (int t = 0; t < 3; t++) parents[g]->randomize(k, t);
+      }
+    }
+    for (int g = 0; g < POPULATION; g++) evaluate(root, *parents[g]);
+
+    while (generations < maxGenerations && high_resolution_clock::now() < deadline) {
+      for (int c = POPULATION; c < 2 * POPULATION; c++) {
+        Genome &a = *parents[fastRand() % POPULATION], &b = *parents[fastRand() % POPULATION];
+        Genome &child = *parents[c];
+        for (int k = 0; k < SEARCH_DEPTH; k++) {
+          for (int t = 0; t < 3; t++) {
+            Genome &from     = (fastRand() & 1) ? a : b;
+            child.angle[k][t]  = from.angle[k][t];
+            child.thrust[k][t] = from.thrust[k][t];
+          }
+        }
+        child.mutate();
+        evaluate(root, child);
+      }
+      sort(parents, parents + 2 * POPULATION, [](Genome *a, Genome *b) { return a->fitness > b->fitness; });
+      generations++;
+    }
+    Genome *best = *max_element(parents, parents + POPULATION,
+                                [](Genome *a, Genome *b) { return a->fitness < b->fitness; });
+    swap(*best, *parents[0]);
+    return *parents[0];
+  }
+
+  void shift() {
+    parents[0]->shift();
+    warm = true;
+  }
+};
+
+// Skill pass: candidate targets for the skill of each of our looters (tar, grenade, oil) are taken around the enemy
+// looters and wrecks in range, plus where the enemy reapers drift to. All of them are played for SKILL_DEPTH turns
+// against the same baseline, the plan alone, and scored by the fitness, which includes the rage spent. The best
+// candidate is cast when it beats the baseline.
+template <typename fitness_function = DefaultFitness>
+struct SkillSearch {
+  Order                candidates[MAX_SKILL_CANDIDATES];
+  int                  caster[MAX_SKILL_CANDIDATES];
+  int                  nbCandidate, evaluations;
+  fitness_function     fitness;
+  const OpponentModel *opponents;
+
+  SkillSearch() : nbCandidate(0), evaluations(0), opponents(nullptr) {}
+
+  static int cost(int type) { return type == REAPER ? TAR_COST : (type == DESTROYER ? GRENADE_COST : OIL_COST); }
+
+  void add(Simulation &root, int type, float px, float py) {
+    int   i  = Simulation::looter(0, type);
+    float dx = px - root.x[i], dy = py - root.y[i];
+    if (nbCandidate == MAX_SKILL_CANDIDATES || dx * dx + dy * dy > SKILL_RANGE * SKILL_RANGE) return;
+    caster[nbCandidate]       = type;
+    candidates[nbCandidate++] = Order(px, py, 0, true);
+  }
+
+  void enumerate(Simulation &root, const SpatialIndex &index) {
+    static const int targets[] = {
+        1 << REAPER | 1 << DESTROYER | 1 << WRECK,  // tar slows enemy looters down, or the ones coming to a wreck
+        1 << REAPER | 1 << WRECK,                   // grenades push everything off a wreck
+        1 << REAPER | 1 << WRECK,                   // oil stops harvesting
+    };
+    int found[MAX_INDEXED];
+    nbCandidate = 0;
+    for (int type = REAPER; type <= DOOF; type++) {
+      if (root.rage[0] < cost(type)) continue;
+      int i = Simulation::looter(0, type);
+      int n = index.radius(root.x[i], root.y[i], SKILL_RANGE, targets[type], found, MAX_INDEXED);
+      for (int f = 0; f < n; f++) {
+        int e = found[f];
+        if (index.type[e] <= DOOF && index.ref[e] < 3) continue;  // our own looters
+        add(root, type, index.x[e], index.y[e]);
+      }
+      for (int p = 1; p < NB_PLAYER; p++) {
+        int r = Simulation::looter(p, REAPER);
+        add(root, type, root.x[r] + root.vx[r], root.y[r] + root.vy[r]);
+      }
+    }
+  }
+
+  // Fitness after SKILL_DEPTH turns of the plan, the first order of `type` replaced by `skill` when given
+  float play(Simulation &root, Genome &plan, int type, const Order *skill) {
+    Simulation sim = root;
+    Order      orders[NB_LOOTER];
+    for (int k = 0; k < SKILL_DEPTH; k++) {
+      for (int t = 0; t < 3; t++) orders[t] = plan.order(sim, k, t);
+      if (k == 0 && skill) orders[type] = *skill;
+      enemyOrders(opponents, sim, k, orders);
+      sim.step(orders);
+    }
+    evaluations++;
+    return fitness(sim);
+  }
+
+  // Index of the best candidate, -1 when no skill beats the plan alone
+  int search(Simulation &root, const SpatialIndex &index, Genome &plan,
+             time_point<high_resolution_clock> deadline) {
+    evaluations = 0;
+    enumerate(root, index);
+    if (nbCandidate == 0) return -1;
+    float bestValue = play(root, plan, -1, nullptr);
+    int   best      = -1;
+    for (int c = 0; c < nbCandidate && high_resolution_clock::now() < deadline; c++) {
+      float value = play(root, plan, caster[c], &candidates[c]);
+      if (value > bestValue) {
+        bestValue = value;
+        best      = c;
+      }
+    }
+    return best;
+  }
+};
+
 int main() {
+  Evolution<>   evolution;
+  SkillSearch<> skills;
+  Simulation    sim;
+  SpatialIndex  index;
+  UnitTable     table;
+  OpponentModel opponents;
+  TurnBudget    budget(FIRST_TURN_TIME, TURN_TIME, TURN_SAFETY);
+  evolution.opponents = skills.opponents = &opponents;
+
   // game loop
   while (1) {
     int myScore;
-    cin >> myScore;
+    if (!(cin >> myScore)) break;
     cin.ignore();
+    budget.startTurn();
     int enemyScore1;
     cin >> enemyScore1;
     cin.ignore();
@@ -82,114 +1190,37 @@ int main() {
     int unitCount;
     cin >> unitCount;
     cin.ignore();
-    vector<Unit> allUnits;
-    Unit         myReaper, myDestroyer, myDoof;
-    Unit         otherReaper1, otherDestroyer1, otherDoof1;
-    Unit         otherReaper2, otherDestroyer2, otherDoof2;
-    vector<Unit> tankers;
-    vector<Unit> wrecks;
-    for (int i = 0; i < unitCount; i++) {
-      int   unitId;
-      int   unitType;
-      int   player;
-      float mass;
-      int   radius;
-      int   x;
-      int   y;
-      int   vx;
-      int   vy;
-      int   nbWater;
-      int   waterCapacity;
-      cin >> unitId >> unitType >> player >> mass >> radius >> x >> y >> vx >> vy >> nbWater >> waterCapacity;
-      cin.ignore();
-      allUnits.push_back(Unit(unitId, unitType, player, mass, radius, x, y, vx, vy, nbWater, waterCapacity));
-      allUnits[i].print();
-      if (allUnits[i].playerId == 0) {
-        if (allUnits[i].type == 0) {
-          myReaper = allUnits[i];
-        } else if (allUnits[i].type == 1) {
-          myDestroyer = allUnits[i];
-        } else if (allUnits[i].type == 2) {
-          myDoof = allUnits[i];
-        }
-      } else if (allUnits[i].playerId == 1) {
-        if (allUnits[i].type == 0) {
-          otherReaper1 = allUnits[i];
-        } else if (allUnits[i].type == 1) {
-          otherDestroyer1 = allUnits[i];
-        } else if (allUnits[i].type == 2) {
-          otherDoof1 = allUnits[i];
-        }
-      } else if (allUnits[i].playerId == 2) {
-        if (allUnits[i].type == 0) {
-          otherReaper2 = allUnits[i];
-        } else if (allUnits[i].type == 1) {
-          otherDestroyer2 = allUnits[i];
-        } else if (allUnits[i].type == 2) {
-          otherDoof2 = allUnits[i];
-        }
-      } else {
-        if (allUnits[i].type == 3) {
-          tankers.push_back(allUnits[i]);
-        } else if (allUnits[i].type == 4) {
-          wrecks.push_back(allUnits[i]);
-        }
-      }
-    }
+    table.read(cin, unitCount);
+    budget.inputParsed();
 
-    Unit closestWreck;
-    int  minDist1 = INT_MAX;
-    for (auto &wreck : wrecks) {
-      int dist = myReaper.distance(wreck);
-      if (minDist1 > dist) {
-        minDist1     = dist;
-        closestWreck = wreck;
-      }
-    }
-    if (closestWreck.id != -1) {
-      cerr << "closest wreck is ";
-      closestWreck.print();
-    }
+    int scores[NB_PLAYER] = {myScore, enemyScore1, enemyScore2};
+    int rages[NB_PLAYER]  = {myRage, enemyRage1, enemyRage2};
+    sim.load(table, scores, rages);
+    opponents.observe(sim);
+    opponents.cache(sim);
+    Genome &plan = evolution.search(sim, budget.deadline - duration_cast<nanoseconds>(duration<double>(SKILL_TIME)));
+    index.build(sim);
+    int skill = skills.search(sim, index, plan, budget.deadline);
+    cerr << "generations=" << evolution.generations << " evaluations=" << evolution.evaluations
+         << " fitness=" << plan.fitness << " skill candidates=" << skills.nbCandidate << endl;
+    cerr << "opponents";
+    for (int i = 3; i < NB_LOOTER; i++) cerr << " " << policy2str[opponents.policy[i]] << ":" << opponents.accuracy(i);
+    cerr << endl;
 
-    Unit closestTanker;
-    int  minDist2 = INT_MAX;
-    for (auto &tanker : tankers) {
-      int dist = myReaper.distance(tanker);
-      if (minDist2 > dist) {
-        minDist2      = dist;
-        closestTanker = tanker;
+    Order played[3];
+    for (int type = REAPER; type <= DOOF; type++) {
+      played[type] = plan.order(sim, 0, type);
+      if (skill != -1 && skills.caster[skill] == type) {
+        played[type] = skills.candidates[skill];
+        cout << "SKILL " << (int)roundf(played[type].x) << " " << (int)roundf(played[type].y) << endl;
+        continue;
       }
+      cout << (int)roundf(played[type].x) << " " << (int)roundf(played[type].y) << " " << played[type].thrust << endl;
     }
-    if (closestTanker.id != -1) {
-      cerr << "closest tanker is ";
-      closestTanker.print();
-    }
-
-    Unit firstReaper = (enemyScore1 > enemyScore2 ? otherReaper1 : otherReaper2);
-
-    // REAPER
-    if (closestWreck.id == -1) {
-      if (closestTanker.id == -1) {
-        cout << "WAIT" << endl;
-      } else {
-        myReaper.goTo(closestTanker);
-      }
-    } else {
-      myReaper.goTo(closestWreck);
-    }
-
-    // DESTROYER
-    if (closestTanker.id == -1) {
-      cout << "WAIT" << endl;
-    } else {
-      if (minDist2 < 1000 && myRage > 60) {
-        cout << "GRENADES " << closestTanker.loc.first << " " << closestTanker.loc.second << endl;
-      } else {
-        myDestroyer.goTo(closestTanker);
-      }
-    }
-
-    // DOOF
-    myDoof.goTo(firstReaper, true);
+    budget.endTurn();
+    budget.report(cerr);
+    opponents.predict(sim, played);
+    evolution.shift();
   }
+  return 0;
 }
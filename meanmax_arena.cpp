@@ -0,0 +1,218 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <immintrin.h>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "turn_budget.h"
+
+// The bot is compiled as is, its main() becomes mm::main. Every header it includes must be included above, so that
+// its own #include lines are no-ops inside the namespace.
+namespace mm {
+#include "meanmax.cpp"
+}
+
+using namespace std;
+using namespace std::chrono;
+
+#define MAX_TURNS (200)
+#define WIN_SCORE (50)
+#define START_RADIUS (2000.0f)
+#define TANKER_SPAWN_RADIUS (MAP_RADIUS + 1000.0f)
+#define TANKER_SPAWN_CHANCE (0.15f)  // per spawn point and turn
+#define TANKER_MIN_CAPACITY (4)
+#define TANKER_MAX_CAPACITY (10)
+#define TANKER_RADIUS_BASE (400.0f)
+#define TANKER_RADIUS_BY_CAPACITY (50.0f)
+
+// Headless referee for three-player Mean Max, on top of the bot's own Simulation which already plays the physics,
+// skills, rage and harvesting. The referee places the looters, spawns tankers at three points on a ring outside the
+// map, and stops the game at WIN_SCORE water or after MAX_TURNS turns. Spawn rates and tanker sizes approximate the
+// live game, they are not read from it.
+struct Referee {
+  mm::Simulation world;
+  uint32_t       state;
+
+  float random() {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state * (1.0f / 4294967296.0f);
+  }
+
+  explicit Referee(uint32_t seed) : state(seed | 1) {
+    float offset = random() * 2 * M_PI;
+    for (int p = 0; p < NB_PLAYER; p++) {
+      for (int t = mm::REAPER; t <= mm::DOOF; t++) {
+        float angle = offset + p * 2 * M_PI / NB_PLAYER + (t - 1) * M_PI / 9;
+        int   i     = mm::Simulation::looter(p, t);
+        world.setLooter(i, i, roundf(START_RADIUS * cosf(angle)), roundf(START_RADIUS * sinf(angle)), 0, 0);
+      }
+    }
+  }
+
+  void spawnTankers() {
+    for (int s = 0; s < NB_PLAYER; s++) {
+      if (random() >= TANKER_SPAWN_CHANCE) continue;
+      float angle    = (world.turn * 7 + s * 120) * M_PI / 180;
+      int   capacity = TANKER_MIN_CAPACITY + (int)(random() * (TANKER_MAX_CAPACITY - TANKER_MIN_CAPACITY + 1));
+      world.addTanker(world.nextId++, roundf(TANKER_SPAWN_RADIUS * cosf(angle)),
+                      roundf(TANKER_SPAWN_RADIUS * sinf(angle)), 0, 0, 1, capacity,
+                      TANKER_RADIUS_BASE + TANKER_RADIUS_BY_CAPACITY * capacity);
+    }
+  }
+
+  bool over() const {
+    if (world.turn >= MAX_TURNS) return true;
+    for (int p = 0; p < NB_PLAYER; p++) {
+      if (world.score[p] >= WIN_SCORE) return true;
+    }
+    return false;
+  }
+};
+
+// The world as seen by player `me`: its looters become player 0, the next player 1 and the other 2
+mm::Simulation rotate(const mm::Simulation &world, int me) {
+  mm::Simulation view = world;
+  for (int p = 0; p < NB_PLAYER; p++) {
+    int v         = (p - me + NB_PLAYER) % NB_PLAYER;
+    view.score[v] = world.score[p];
+    view.rage[v]  = world.rage[p];
+    for (int t = mm::REAPER; t <= mm::DOOF; t++) {
+      int i = mm::Simulation::looter(p, t), j = mm::Simulation::looter(v, t);
+      view.x[j]             = world.x[i];
+      view.y[j]             = world.y[i];
+      view.vx[j]            = world.vx[i];
+      view.vy[j]            = world.vy[i];
+      view.mass[j]          = world.mass[i];
+      view.friction[j]      = world.friction[i];
+      view.radius[j]        = world.radius[i];
+      view.effectiveMass[j] = world.effectiveMass[i];
+      view.id[j]            = world.id[i];
+    }
+  }
+  return view;
+}
+
+// A bot configuration: "rules" and "planned" play heuristicOrders, "evoN" runs the evolution for N generations a
+// turn with the opponent model and the skill pass, "evoN-noskill" without the skill pass
+struct Bot {
+  string            name;
+  int               generations;
+  bool              planned, skill;
+  mm::Evolution<>   evolution;
+  mm::SkillSearch<> skills;
+  mm::OpponentModel opponents;
+  mm::SpatialIndex  index;
+
+  explicit Bot(const string &config) : name(config), generations(0), planned(config == "planned"), skill(false) {
+    if (config.compare(0, 3, "evo") == 0) {
+      generations = max(1, atoi(config.c_str() + 3));
+      skill       = (config.find("-noskill") == string::npos);
+    }
+    evolution.maxGenerations = generations;
+    evolution.opponents = skills.opponents = &opponents;
+  }
+
+  // Orders of player `me`, written to its looters' slots of `orders`
+  void play(const mm::Simulation &world, int me, mm::Order *orders) {
+    mm::Simulation view = rotate(world, me);
+    mm::Order      mine[NB_LOOTER];
+    if (generations == 0) {
+      mm::heuristicOrders(view, 0, mine, planned);
+    } else {
+      time_point<high_resolution_clock> never = high_resolution_clock::now() + hours(1);
+      opponents.observe(view);
+      opponents.cache(view);
+      mm::Genome &plan = evolution.search(view, never);
+      for (int t = mm::REAPER; t <= mm::DOOF; t++) mine[t] = plan.order(view, 0, t);
+      if (skill) {
+        index.build(view);
+        int c = skills.search(view, index, plan, never);
+        if (c != -1) mine[skills.caster[c]] = skills.candidates[c];
+      }
+      opponents.predict(view, mine);
+      evolution.shift();
+    }
+    for (int t = mm::REAPER; t <= mm::DOOF; t++) orders[mm::Simulation::looter(me, t)] = mine[t];
+  }
+};
+
+struct Results {
+  int    games;
+  double wins, score, rank;
+  Results() : games(0), wins(0), score(0), rank(0) {}
+};
+
+// Play game number g: configurations rotate over the seats so that no one keeps the same spawn side
+void playGame(const vector<string> &configs, int g, uint32_t seed, vector<Results> &results, mutex &lock) {
+  mm::rngState = (seed * 2654435761u) | 1;
+  Referee       referee(seed);
+  vector<Bot *> bots;
+  int           seat[NB_PLAYER];
+  for (int p = 0; p < NB_PLAYER; p++) {
+    seat[p] = (p + g) % NB_PLAYER;
+    bots.push_back(new Bot(configs[seat[p]]));
+  }
+  mm::Order orders[NB_LOOTER];
+  while (!referee.over()) {
+    referee.spawnTankers();
+    for (int p = 0; p < NB_PLAYER; p++) bots[p]->play(referee.world, p, orders);
+    referee.world.step(orders);
+  }
+
+  lock_guard<mutex> guard(lock);
+  for (int p = 0; p < NB_PLAYER; p++) {
+    int better = 0, equal = 0;
+    for (int q = 0; q < NB_PLAYER; q++) {
+      if (q == p) continue;
+      better += (referee.world.score[q] > referee.world.score[p]);
+      equal += (referee.world.score[q] == referee.world.score[p]);
+    }
+    Results &r = results[seat[p]];
+    r.games++;
+    r.score += referee.world.score[p];
+    r.rank += 1 + better + equal / 2.0;
+    if (better == 0) r.wins += 1.0 / (1 + equal);
+    delete bots[p];
+  }
+}
+
+int main(int argc, char const *argv[]) {
+  int            nbGame   = (argc > 1 ? atoi(argv[1]) : 30);
+  int            nbThread = (argc > 2 ? atoi(argv[2]) : max(1u, thread::hardware_concurrency()));
+  vector<string> configs  = {"evo10", "planned", "rules"};
+  for (int p = 0; p < NB_PLAYER && 3 + p < argc; p++) configs[p] = argv[3 + p];
+  uint32_t seed = 42;
+
+  vector<Results> results(NB_PLAYER);
+  mutex           lock;
+  atomic<int>     next(0);
+  auto            start = high_resolution_clock::now();
+  vector<thread>  threads;
+  for (int t = 0; t < nbThread; t++) {
+    threads.push_back(thread([&]() {
+      for (int g = next++; g < nbGame; g = next++) playGame(configs, g, seed + g, results, lock);
+    }));
+  }
+  for (auto &t : threads) t.join();
+  duration<double> elapsed = high_resolution_clock::now() - start;
+
+  cout << nbGame << " games in " << fixed << setprecision(1) << elapsed.count() << "s (" << setprecision(2)
+       << nbGame / elapsed.count() << " games/s, " << nbThread << " threads)" << endl;
+  cout << "config,games,win_rate,mean_score,mean_rank" << endl;
+  for (int c = 0; c < NB_PLAYER; c++) {
+    Results &r = results[c];
+    cout << configs[c] << "," << r.games << "," << setprecision(3) << r.wins / max(1, r.games) << ","
+         << setprecision(2) << r.score / max(1, r.games) << "," << r.rank / max(1, r.games) << endl;
+  }
+  return 0;
+}
@@ -0,0 +1,95 @@
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <immintrin.h>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "turn_budget.h"
+
+// The bot is compiled as is, its main() becomes mm::main. Every header it includes must be included above, so that
+// its own #include lines are no-ops inside the namespace.
+namespace mm {
+#include "meanmax.cpp"
+}
+
+using namespace std;
+using namespace std::chrono;
+
+#define NB_STATE (1000)
+
+static volatile double sink;
+
+// Random states with the 9 looters and `nbTanker` tankers packed in the middle of the map, so that many pairs collide
+vector<mm::Simulation> generate(int nbTanker, uint32_t seed) {
+  mm::rngState = seed;
+  vector<mm::Simulation> states(NB_STATE);
+  for (auto &sim : states) {
+    for (int i = 0; i < NB_LOOTER; i++) {
+      sim.setLooter(i, i, 8000 * (mm::randFloat() - 0.5f), 8000 * (mm::randFloat() - 0.5f),
+                    600 * (mm::randFloat() - 0.5f), 600 * (mm::randFloat() - 0.5f));
+    }
+    for (int t = 0; t < nbTanker; t++) {
+      sim.addTanker(100 + t, 10000 * (mm::randFloat() - 0.5f), 10000 * (mm::randFloat() - 0.5f),
+                    200 * (mm::randFloat() - 0.5f), 200 * (mm::randFloat() - 0.5f), 1, 8, 600);
+    }
+  }
+  return states;
+}
+
+template <typename kernel_function>
+double nanosPerCall(vector<mm::Simulation> &states, int rounds, kernel_function &&kernel, double &checksum) {
+  auto start = high_resolution_clock::now();
+  for (int r = 0; r < rounds; r++) {
+    for (auto &sim : states) {
+      int ci = -1, cj = -1;
+      checksum += kernel(sim, ci, cj) + ci + cj;
+    }
+  }
+  duration<double, nano> elapsed = high_resolution_clock::now() - start;
+  return elapsed.count() / rounds / states.size();
+}
+
+// Scalar against AVX earliest-collision kernel: both must agree on every state, then ns per call of each and the
+// cost of a whole turn of movement
+int main(int argc, char const *argv[]) {
+  int rounds = (argc > 1 ? atoi(argv[1]) : 200);
+  cout << "bodies,mismatches,scalar_ns,avx_ns,speedup,move_us" << endl;
+  for (int nbTanker : {6, 14, 23}) {
+    vector<mm::Simulation> states = generate(nbTanker, 2463534242u + nbTanker);
+
+    int mismatches = 0;
+    for (auto &sim : states) {
+      int   si = -1, sj = -1, vi = -1, vj = -1;
+      float ts = sim.firstCollisionScalar(1.0f, -1, -1, si, sj);
+      float tv = sim.firstCollision(1.0f, -1, -1, vi, vj);
+      mismatches += (ts != tv || si != vi || sj != vj);
+    }
+
+    double checksum = 0;
+    auto   scalar   = [](mm::Simulation &sim, int &ci, int &cj) {
+      return sim.firstCollisionScalar(1.0f, -1, -1, ci, cj);
+    };
+    auto avx = [](mm::Simulation &sim, int &ci, int &cj) { return sim.firstCollision(1.0f, -1, -1, ci, cj); };
+    double scalarTime = nanosPerCall(states, rounds, scalar, checksum);
+    double avxTime    = nanosPerCall(states, rounds, avx, checksum);
+
+    auto start = high_resolution_clock::now();
+    for (auto &sim : states) {
+      mm::Simulation copy = sim;
+      copy.move();
+      checksum += copy.x[0];
+    }
+    duration<double, micro> moveTime = high_resolution_clock::now() - start;
+
+    cout << NB_LOOTER + nbTanker << "," << mismatches << "," << fixed << setprecision(1) << scalarTime << ","
+         << avxTime << "," << setprecision(2) << scalarTime / avxTime << "," << moveTime.count() / states.size()
+         << defaultfloat << endl;
+    sink = checksum;
+  }
+  return 0;
+}
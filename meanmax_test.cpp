@@ -0,0 +1,70 @@
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <immintrin.h>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "turn_budget.h"
+
+// The bot is compiled as is, its main() becomes mm::main. Every header it includes must be included above, so that
+// its own #include lines are no-ops inside the namespace.
+namespace mm {
+#include "meanmax.cpp"
+}
+
+using namespace std;
+
+static int failures = 0;
+
+static void check(bool ok, const string &what) {
+  cout << (ok ? "ok   " : "FAIL ") << what << endl;
+  failures += !ok;
+}
+
+// The looters of the three players on a line far from the action, at rest
+static void parkLooters(mm::Simulation &sim) {
+  for (int i = 0; i < NB_LOOTER; i++) {
+    sim.setLooter(i, i, -4000 + 1000 * i, -4000, 0, 0);
+  }
+}
+
+// A destroyer runs into a tanker, which is destroyed and replaced in its slot by the last tanker. That one lies
+// further on the destroyer's way and must be destroyed too in the same turn.
+static void destroyerMeetsSwappedTanker() {
+  mm::Simulation sim;
+  parkLooters(sim);
+  int destroyer = mm::Simulation::looter(0, mm::DESTROYER);
+  sim.setLooter(destroyer, destroyer, 0, 0, 1000, 0);
+  sim.addTanker(100, 1000, 0, 0, 0, 1, 8, 600);  // touching the destroyer
+  sim.addTanker(101, 1700, 0, 0, 0, 1, 8, 600);  // met around t = 0.6
+  mm::Order orders[NB_LOOTER];
+  sim.step(orders);
+  check(sim.nbBody == NB_LOOTER && sim.nbWreck == 2, "destroyer meets the tanker swapped into the slot it emptied");
+}
+
+// A destroyed tanker hands its slot to a tanker sitting in tar, which must stay as heavy as it was
+static void swappedTankerKeepsTarMass() {
+  mm::Simulation sim;
+  parkLooters(sim);
+  int destroyer = mm::Simulation::looter(0, mm::DESTROYER);
+  sim.setLooter(destroyer, destroyer, 0, 0, 1000, 0);
+  sim.addTanker(100, 1000, 0, 0, 0, 1, 8, 600);
+  sim.addTanker(101, 0, 3000, 0, 0, 1, 8, 600);
+  sim.addEffect(mm::TAR, 0, 3000, TAR_DURATION);
+  float mass = TANKER_EMPTY_MASS + TANKER_MASS_BY_WATER + TAR_MASS_BONUS;
+  mm::Order orders[NB_LOOTER];
+  sim.step(orders);
+  check(sim.nbBody == NB_LOOTER + 1 && sim.id[NB_LOOTER] == 101 && sim.effectiveMass[NB_LOOTER] == mass,
+        "tanker swapped into a destroyed one's slot keeps its tar mass");
+}
+
+int main() {
+  destroyerMeetsSwappedTanker();
+  swappedTankerKeepsTarMass();
+  return failures > 0;
+}
@@ -0,0 +1,104 @@
+#ifndef TURN_BUDGET_H
+#define TURN_BUDGET_H
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+#define BUDGET_SAMPLE_PERIOD (5e-5)  // seconds between two clock reads of shouldStop()
+#define BUDGET_MAX_STRIDE (1 << 16)
+
+// Time budget of the turns of a bot. A turn's clock starts when its first input line has been read, which is when the
+// referee starts timing us: the time spent blocked before that (the opponents' turns) is recorded as the wait, the
+// time from there to inputParsed() as the parse. Searches stop at the deadline, the allowance of the turn minus a
+// safety fraction kept for the output, either by comparing to `deadline` or by polling shouldStop(), which only reads
+// the clock every `stride` calls, sized from the measured cost of a call. endTurn() records the margin left against
+// the allowance, so that the safety can be tuned down from the worst margin seen.
+struct TurnBudget {
+  typedef std::chrono::high_resolution_clock clock;
+
+  double            firstAllowance, allowance;  // seconds, the limits of the referee
+  double            safety;                     // fraction of the allowance not used by the searches
+  clock::time_point turnStart, deadline, lastEnd;
+  int               turn;
+  double            waitTime, parseTime, usedTime;  // seconds, last turn
+  double            worstMargin, totalMargin;       // seconds, over the turns after the first
+  int               overruns;
+  unsigned          stride, countdown;
+  clock::time_point lastSample;
+  bool              stopped;
+
+  TurnBudget(double first, double perTurn, double s)
+      : firstAllowance(first),
+        allowance(perTurn),
+        safety(s),
+        turnStart(clock::now()),
+        deadline(turnStart),
+        lastEnd(turnStart),
+        turn(0),
+        waitTime(0),
+        parseTime(0),
+        usedTime(0),
+        worstMargin(perTurn),
+        totalMargin(0),
+        overruns(0),
+        stride(1),
+        countdown(1),
+        lastSample(turnStart),
+        stopped(false) {}
+
+  double limit() const { return turn <= 1 ? firstAllowance : allowance; }
+
+  // Call right after reading the first line of a turn
+  void startTurn() {
+    turnStart = clock::now();
+    turn++;
+    waitTime = std::chrono::duration<double>(turnStart - lastEnd).count();
+    deadline = turnStart + std::chrono::duration_cast<clock::duration>(
+                               std::chrono::duration<double>(limit() * (1.0 - safety)));
+    stride     = 1;
+    countdown  = 1;
+    lastSample = turnStart;
+    stopped    = false;
+  }
+  void inputParsed() { parseTime = elapsed(); }
+
+  double elapsed() const { return std::chrono::duration<double>(clock::now() - turnStart).count(); }
+  double remaining() const { return std::chrono::duration<double>(deadline - clock::now()).count(); }
+
+  // True once the deadline is passed, noticed at most about BUDGET_SAMPLE_PERIOD late
+  bool shouldStop() {
+    if (stopped) return true;
+    if (--countdown > 0) return false;
+    clock::time_point now    = clock::now();
+    double            period = std::chrono::duration<double>(now - lastSample).count();
+    stride    = std::max(1u, std::min((unsigned)BUDGET_MAX_STRIDE,
+                                   period > 0 ? (unsigned)(stride * BUDGET_SAMPLE_PERIOD / period) : 2 * stride));
+    countdown  = stride;
+    lastSample = now;
+    stopped    = (now >= deadline);
+    return stopped;
+  }
+
+  // Call once the output of the turn has been flushed
+  void endTurn() {
+    lastEnd       = clock::now();
+    usedTime      = std::chrono::duration<double>(lastEnd - turnStart).count();
+    double margin = limit() - usedTime;
+    if (margin < 0) overruns++;
+    if (turn > 1) {
+      worstMargin = std::min(worstMargin, margin);
+      totalMargin += margin;
+    }
+  }
+
+  void report(std::ostream &out) const {
+    out << "turn=" << turn << " wait=" << waitTime * 1e3 << "ms parse=" << parseTime * 1e3
+        << "ms used=" << usedTime * 1e3 << "/" << limit() * 1e3 << "ms margin=" << (limit() - usedTime) * 1e3
+        << "ms worst_margin=" << worstMargin * 1e3
+        << "ms mean_margin=" << (turn > 1 ? totalMargin / (turn - 1) * 1e3 : 0) << "ms overruns=" << overruns
+        << std::endl;
+  }
+};
+
+#endif
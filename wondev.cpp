@@ -1,10 +1,15 @@
 #include <algorithm>
+#include <cstdint>
 #include <iostream>
 #include <map>
 #include <sstream>
 #include <string>
+#include <type_traits>
 #include <vector>
 
+#include "turn_budget.h"
+#include "wondev_book.h"
+
 #pragma GCC target("avx")
 #pragma GCC optimize("O3")
 #pragma GCC optimize("omit-frame-pointer")
@@ -13,7 +18,17 @@
 
 using namespace std;
 
-#define DEPTH (3)
+#define DEPTH (3)      // deepest search played without timing, the deepening goes on from there while time allows
+#define MAX_DEPTH (12)
+#define FIRST_TURN_TIME (1.0)
+#define TURN_TIME (0.05)
+#define TURN_SAFETY (0.2)
+#define MAX_SIZE (7)   // boards are 5 to 7 cells wide
+#define MAX_UNITS (4)  // 2 players with 1 or 2 units each
+#define LMR_FIRST_MOVES (3)      // moves of a node searched at full depth before the others get reduced
+#define FUTILITY_MARGIN (1500)  // most a reply can gain back: a point and some mobility
+#define BOOK_SEED (0x5EED0F800CULL)
+#define BELIEF_PLACE_MAX (6)  // hidden units narrowed down to this few cells are put in the search
 
 static bool input_debug = true;
 static bool trace_debug = false;
@@ -110,8 +125,8 @@ void getPreviousPosition(int &x, int &y, int dir) {
 }
 
 struct Cell {
-  int height;
-  int unitIdx;
+  int8_t height;
+  int8_t unitIdx;
 
   Cell() : height(-1), unitIdx(-1) {}
 
@@ -126,7 +141,7 @@ struct Cell {
 
   void display(void) {
     if (trace_debug)
-      cerr << "height=" << height << ", unitIdx=" << unitIdx << ", isPlayable=" << (height != -1 ? "yes" : "no")
+      cerr << "height=" << (int)height << ", unitIdx=" << (int)unitIdx << ", isPlayable=" << (height != -1 ? "yes" : "no")
            << endl;
   }
 };
@@ -150,19 +165,23 @@ struct Action {
   void print() { cout << this->toString() << endl; }
 };
 
+struct Coord {
+  int8_t x;
+  int8_t y;
+};
+
+// Fixed-size and trivially copyable, so that copying a State for copy-make is a couple of cache lines and no
+// allocation. Cells are indexed x + size * y whatever the size of the board.
 struct State {
-  int          actionScore;
-  int          myScore;
-  int          otherScore;
-  vector<Cell> board;
-  vector<pair<int, int> > players;
-
-  State()
-      : actionScore(0),
-        myScore(0),
-        otherScore(0),
-        board(vector<Cell>(size * size, Cell())),
-        players(vector<pair<int, int> >(2 * unitsPerPlayer, pair<int, int>(0, 0))) {}
+  int   actionScore;
+  int   myScore;
+  int   otherScore;
+  Coord players[MAX_UNITS];
+  Cell  board[MAX_SIZE * MAX_SIZE];
+
+  State() : actionScore(0), myScore(0), otherScore(0) {
+    for (auto &p : players) p = {0, 0};
+  }
 
   bool operator<(const State &a) const { return actionScore < a.actionScore; }
 
@@ -176,8 +195,8 @@ struct State {
     int firstUnit = (myTurn ? 0 : unitsPerPlayer);
     actions.clear();
     for (int unitId = firstUnit; unitId < firstUnit + unitsPerPlayer; unitId++) {
-      int x = players[unitId].first;
-      int y = players[unitId].second;
+      int x = players[unitId].x;
+      int y = players[unitId].y;
       if (x == -1 || y == -1) {
         continue;
       }
@@ -266,15 +285,15 @@ struct State {
     // if (trace_debug) cerr << action.toString() << endl;
     switch (action.atype) {
       case MOVE_BUILD: {
-        int x = players[action.index].first;
-        int y = players[action.index].second;
+        int x = players[action.index].x;
+        int y = players[action.index].y;
         // move player
         // if (trace_debug) cerr << "move player at " << x << "," << y << " to " << dir2str[action.dir1] << endl;
         board[x + size * y].assignUnit(-1);
         getNewPosition(x, y, action.dir1);
         board[x + size * y].assignUnit(action.index);
-        players[action.index].first  = x;
-        players[action.index].second = y;
+        players[action.index].x  = x;
+        players[action.index].y = y;
         if (board[x + size * y].height == 3) {
           if (action.index < unitsPerPlayer) {
             myScore++;
@@ -289,8 +308,8 @@ struct State {
         break;
       }
       case PUSH_BUILD: {
-        int x = players[action.index].first;
-        int y = players[action.index].second;
+        int x = players[action.index].x;
+        int y = players[action.index].y;
         // move other player
         // if (trace_debug) cerr << "move player at " << x << "," << y << " to " << dir2str[action.dir1] << endl;
         getNewPosition(x, y, action.dir1);
@@ -300,8 +319,8 @@ struct State {
 
         getNewPosition(x, y, action.dir2);
         board[x + size * y].assignUnit(otherPlayerIndex);
-        players[otherPlayerIndex].first  = x;
-        players[otherPlayerIndex].second = y;
+        players[otherPlayerIndex].x  = x;
+        players[otherPlayerIndex].y = y;
 
         break;
       }
@@ -313,8 +332,8 @@ struct State {
   void undoAction(Action &action) {
     switch (action.atype) {
       case MOVE_BUILD: {
-        int x = players[action.index].first;
-        int y = players[action.index].second;
+        int x = players[action.index].x;
+        int y = players[action.index].y;
         // remove point
         if (board[x + size * y].height == 3) {
           if (action.index < unitsPerPlayer) {
@@ -331,13 +350,13 @@ struct State {
         board[x + size * y].assignUnit(-1);
         getPreviousPosition(x, y, action.dir1);
         board[x + size * y].assignUnit(action.index);
-        players[action.index].first  = x;
-        players[action.index].second = y;
+        players[action.index].x  = x;
+        players[action.index].y = y;
         break;
       }
       case PUSH_BUILD: {
-        int x = players[action.index].first;
-        int y = players[action.index].second;
+        int x = players[action.index].x;
+        int y = players[action.index].y;
         // unbuild
         getNewPosition(x, y, action.dir1);
         board[x + size * y].unbuild();
@@ -347,8 +366,8 @@ struct State {
         int otherPlayerIndex = board[xo + size * yo].unitIdx;
         board[xo + size * yo].assignUnit(-1);
         board[x + size * y].assignUnit(otherPlayerIndex);
-        players[otherPlayerIndex].first  = x;
-        players[otherPlayerIndex].second = y;
+        players[otherPlayerIndex].x  = x;
+        players[otherPlayerIndex].y = y;
         break;
       }
       default:
@@ -359,8 +378,8 @@ struct State {
   void evaluateState(void) {
     actionScore = 1000 * (myScore - otherScore);
     for (int i = 0; i < unitsPerPlayer; i++) {
-      int   x          = players[i].first;
-      int   y          = players[i].second;
+      int   x          = players[i].x;
+      int   y          = players[i].y;
       int   nbMoveable = 0;
       int   unitScore  = 0;
       Cell &cell       = board[x + size       *y];
@@ -398,8 +417,8 @@ struct State {
       for (int i = 0; i < size; i++) {
         cerr << "[ ";
         for (int j = 0; j < size; j++) {
-          cerr << "(" << (board[j + size * i].height >= 0 ? " " : "") << board[j + size * i].height << ","
-               << (board[j + size * i].unitIdx >= 0 ? " " : "") << board[j + size * i].unitIdx << ") ";
+          cerr << "(" << (board[j + size * i].height >= 0 ? " " : "") << (int)board[j + size * i].height << ","
+               << (board[j + size * i].unitIdx >= 0 ? " " : "") << (int)board[j + size * i].unitIdx << ") ";
         }
         cerr << "]" << endl;
       }
@@ -408,6 +427,221 @@ struct State {
     }
   }
 };
+static_assert(is_trivially_copyable<State>::value, "State is copied at every node of Minimax");
+
+// Zobrist keys of the heights of the cells and of the units standing on them, drawn from a fixed seed so that the bot
+// and the book generator agree. Units are keyed by owner only, the book does not care which of them is which.
+struct Zobrist {
+  uint64_t height[MAX_SIZE * MAX_SIZE][6];  // hole, then heights 0 to 4
+  uint64_t unit[MAX_SIZE * MAX_SIZE][2];    // mine, the opponent's
+  uint64_t width[MAX_SIZE + 1];
+  uint64_t units[MAX_UNITS / 2 + 1];
+
+  Zobrist() {
+    uint64_t seed = BOOK_SEED;
+    for (auto &keys : height)
+      for (auto &key : keys) key = splitmix(seed);
+    for (auto &keys : unit)
+      for (auto &key : keys) key = splitmix(seed);
+    for (auto &key : width) key = splitmix(seed);
+    for (auto &key : units) key = splitmix(seed);
+  }
+  static uint64_t splitmix(uint64_t &seed) {
+    uint64_t z = (seed += 0x9E3779B97F4A7C15ULL);
+    z          = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z          = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+  }
+};
+static const Zobrist zobrist;
+
+static const int dirX[DIR_MAX] = {0, 1, 1, 1, 0, -1, -1, -1};
+static const int dirY[DIR_MAX] = {-1, -1, 0, 1, 1, 1, 0, -1};
+
+// The 8 symmetries of the board: bit 2 transposes, then bit 0 mirrors x and bit 1 mirrors y
+void transform(int symmetry, int &x, int &y) {
+  if (symmetry & 4) swap(x, y);
+  if (symmetry & 1) x = size - 1 - x;
+  if (symmetry & 2) y = size - 1 - y;
+}
+
+int transformDir(int symmetry, int dir) {
+  int dx = dirX[dir], dy = dirY[dir];
+  if (symmetry & 4) swap(dx, dy);
+  if (symmetry & 1) dx = -dx;
+  if (symmetry & 2) dy = -dy;
+  for (int d = 0; d < DIR_MAX; d++) {
+    if (dirX[d] == dx && dirY[d] == dy) return d;
+  }
+  return dir;
+}
+
+uint64_t hashState(const State &state, int symmetry) {
+  uint64_t hash = zobrist.width[size] ^ zobrist.units[unitsPerPlayer];
+  for (int y = 0; y < size; y++) {
+    for (int x = 0; x < size; x++) {
+      const Cell &cell = state.board[x + size * y];
+      int         tx = x, ty = y;
+      transform(symmetry, tx, ty);
+      hash ^= zobrist.height[tx + size * ty][cell.height + 1];
+      if (cell.unitIdx != -1) hash ^= zobrist.unit[tx + size * ty][cell.unitIdx >= unitsPerPlayer];
+    }
+  }
+  return hash;
+}
+
+// Smallest hash of the state over the symmetries of the board, and the symmetry giving it
+uint64_t canonicalHash(const State &state, int &symmetry) {
+  uint64_t best = UINT64_MAX;
+  for (int s = 0; s < 8; s++) {
+    uint64_t hash = hashState(state, s);
+    if (hash < best) {
+      best     = hash;
+      symmetry = s;
+    }
+  }
+  return best;
+}
+
+// A book move, in the canonical frame of its position: the cell of the unit played, the action type and directions
+uint16_t encodeBookMove(const State &state, int symmetry, const Action &action) {
+  int x = state.players[action.index].x, y = state.players[action.index].y;
+  transform(symmetry, x, y);
+  return (x + size * y) | action.atype << 6 | transformDir(symmetry, action.dir1) << 7 |
+         transformDir(symmetry, action.dir2) << 10;
+}
+
+// Looks the position up in the compiled-in book, the move found is played only if it is among the legal `actions`
+bool bookMove(const State &state, const vector<Action> &actions, Action &move) {
+  int             symmetry = 0;
+  uint64_t        hash     = canonicalHash(state, symmetry);
+  const uint64_t *entry    = lower_bound(bookKeys, bookKeys + BOOK_ENTRIES, hash);
+  if (entry == bookKeys + BOOK_ENTRIES || *entry != hash) return false;
+  uint16_t code = bookMoves[entry - bookKeys];
+  for (auto &action : actions) {
+    if (encodeBookMove(state, symmetry, action) == code) {
+      move = action;
+      return true;
+    }
+  }
+  return false;
+}
+
+// Cells a hidden opponent unit can be on, as a bitmask over the cells x + size * y. The opponent's action shows as a
+// cell one floor higher than our own action left it: the unit that made it has stepped next to that cell, unless
+// another unit did it and this one stayed put. Cells next to our units are in sight, no hidden unit is there.
+struct Belief {
+  uint64_t possible[MAX_UNITS];           // opponent units only
+  int8_t   expected[MAX_SIZE * MAX_SIZE];  // heights once our last action is applied
+  bool     tracking;
+
+  Belief() : tracking(false) {}
+
+  static uint64_t bit(int x, int y) { return 1ULL << (x + size * y); }
+
+  // The cells of `mask` and their neighbours
+  static uint64_t around(uint64_t mask) {
+    uint64_t result = mask;
+    for (int c = 0; c < size * size; c++) {
+      if (!(mask >> c & 1)) continue;
+      for (int dir = 0; dir < DIR_MAX; dir++) {
+        int x = c % size, y = c / size;
+        getNewPosition(x, y, dir);
+        if (x != -1) result |= bit(x, y);
+      }
+    }
+    return result;
+  }
+
+  // Cells a unit on a cell of `mask` can move to, at most a floor up and not onto a dome
+  static uint64_t step(uint64_t mask, const int8_t *height) {
+    uint64_t result = 0;
+    for (int c = 0; c < size * size; c++) {
+      if (!(mask >> c & 1)) continue;
+      for (int dir = 0; dir < DIR_MAX; dir++) {
+        int x = c % size, y = c / size;
+        getNewPosition(x, y, dir);
+        if (x == -1) continue;
+        int h = height[x + size * y];
+        if (h >= 0 && h < 4 && h <= height[c] + 1) result |= bit(x, y);
+      }
+    }
+    return result;
+  }
+
+  // Call with each turn's input, before searching
+  void update(const State &state) {
+    uint64_t open = 0, built = 0, sight = 0;
+    int      builds = 0;
+    for (int u = 0; u < unitsPerPlayer; u++) {
+      if (state.players[u].x != -1) sight |= bit(state.players[u].x, state.players[u].y);
+    }
+    sight = around(sight);
+    for (int c = 0; c < size * size; c++) {
+      const Cell &cell = state.board[c];
+      if (cell.height >= 0 && cell.height < 4 && cell.unitIdx == -1 && !(sight >> c & 1)) open |= 1ULL << c;
+      if (tracking && cell.height > expected[c]) {
+        built |= 1ULL << c;
+        builds++;
+      }
+    }
+    for (int u = unitsPerPlayer; u < 2 * unitsPerPlayer; u++) {
+      if (state.players[u].x != -1) {
+        possible[u] = bit(state.players[u].x, state.players[u].y);
+        continue;
+      }
+      if (!tracking) {
+        possible[u] = open;
+        continue;
+      }
+      // more than one build means we got pushed and mispredicted our own, anything one step away goes then
+      uint64_t moved = step(possible[u], expected);
+      possible[u] |= (builds == 1 ? moved & around(built) : builds > 1 ? moved : 0);
+      possible[u] &= open;
+      if (possible[u] == 0) possible[u] = open;
+    }
+    tracking = true;
+  }
+
+  // Call with the action we played, or none. A unit we pushed is where we pushed it, even if out of sight now.
+  void played(const State &state, Action *action) {
+    State next = state;
+    if (action) next.applyAction(*action);
+    for (int c = 0; c < size * size; c++) expected[c] = next.board[c].height;
+    for (int u = unitsPerPlayer; u < 2 * unitsPerPlayer; u++) {
+      if (next.players[u].x != -1) possible[u] = bit(next.players[u].x, next.players[u].y);
+    }
+  }
+
+  int count(int unit) const { return __builtin_popcountll(possible[unit]); }
+
+  // Puts the hidden units narrowed down to at most BELIEF_PLACE_MAX cells on the one of them nearest to our units,
+  // the worst case for us, so that the search sees them. The others stay out of the search and its branching.
+  int place(State &state) const {
+    int placed = 0;
+    for (int u = unitsPerPlayer; u < 2 * unitsPerPlayer; u++) {
+      if (state.players[u].x != -1 || !tracking || count(u) > BELIEF_PLACE_MAX) continue;
+      int best = -1, bestDistance = size;
+      for (int c = 0; c < size * size; c++) {
+        if (!(possible[u] >> c & 1) || state.board[c].unitIdx != -1) continue;
+        int distance = size;
+        for (int m = 0; m < unitsPerPlayer; m++) {
+          if (state.players[m].x == -1) continue;
+          distance = min(distance, max(abs(c % size - state.players[m].x), abs(c / size - state.players[m].y)));
+        }
+        if (best == -1 || distance < bestDistance) {
+          best         = c;
+          bestDistance = distance;
+        }
+      }
+      if (best == -1) continue;
+      state.players[u]          = {(int8_t)(best % size), (int8_t)(best / size)};
+      state.board[best].unitIdx = u;
+      placed++;
+    }
+    return placed;
+  }
+};
 
 struct Minimax {
   int            depthMax;
@@ -458,14 +692,56 @@ struct Minimax {
 struct AlphaBeta {
   int            depthMax;
   vector<Action> initialActions;
-  AlphaBeta() : depthMax(0) {}
-  AlphaBeta(int d) : depthMax(d) {}
-  void          doAlphaBeta(
+  TurnBudget    *budget;   // the search gives up when it runs out, if set
+  bool           aborted;  // the last search gave up, its result is not to be used
+  // selective search, each technique can be switched off on its own
+  bool ordering;    // search the moves in order of their static evaluation where more than a ply is left below
+  bool reductions;  // late moves are searched a ply shallower
+  bool futility;    // one ply above the leaves, skip the replies to a move hopeless even with FUTILITY_MARGIN
+  bool research;    // reduced moves are searched with a null window, and again at full depth if they beat it
+  long long nodes;
+  AlphaBeta() : AlphaBeta(0) {}
+  AlphaBeta(int d)
+      : depthMax(d),
+        budget(NULL),
+        aborted(false),
+        ordering(true),
+        reductions(true),
+        futility(true),
+        research(true),
+        nodes(0) {}
+
+  // Switches on the techniques named in `techniques` (order, lmr, futility, research) and off the others
+  void select(const string &techniques) {
+    ordering   = (techniques.find("order") != string::npos);
+    reductions = (techniques.find("lmr") != string::npos);
+    futility   = (techniques.find("futility") != string::npos);
+    research   = (techniques.find("research") != string::npos);
+  }
+
+  // Best first for the player to move, by the static evaluation of the state each move leads to
+  void order(State &state, vector<Action> &actions, bool myTurn) {
+    for (auto &action : actions) {
+      state.actionScore = 0;
+      state.applyAction(action);
+      state.evaluateState();
+      action.score = state.actionScore;
+      state.undoAction(action);
+    }
+    if (myTurn) {
+      stable_sort(actions.begin(), actions.end(), [](const Action &a, const Action &b) { return b < a; });
+    } else {
+      stable_sort(actions.begin(), actions.end());
+    }
+  }
+
+  void doAlphaBeta(
       State &state, int depth, int alpha, int beta, bool myTurn, bool &foundBestAction, Action &bestAction) {
     // cerr << "DEPTH=" << depth << ", myTurn=" << myTurn << endl;
     vector<Action> actions;
     Action         nextAction;
     foundBestAction = false;
+    nodes++;
 
     if (depth > 1) {
       state.computePossibleActions(actions, myTurn);
@@ -481,28 +757,60 @@ struct AlphaBeta {
       }
     }
 
-    for (auto &action : (depth == 1 ? initialActions : actions)) {
+    vector<Action> &moves     = (depth == 1 ? initialActions : actions);
+    int             remaining = depthMax - depth;  // plies searched below the moves of this node
+    if (ordering && remaining >= 2) order(state, moves, myTurn);
+
+    int index = 0;
+    for (auto &action : moves) {
+      if (budget && budget->shouldStop()) {
+        aborted = true;
+        break;
+      }
       if (trace_debug) cerr << string(3 * depth, ' ') << action.toString() << endl;
       // State state       = state;
+      int scores        = state.myScore + state.otherScore;
       state.actionScore = 0;
       state.applyAction(action);
       // state.printState();
+      bool quiet = (state.myScore + state.otherScore == scores);
 
       if (depth == depthMax) {
         state.evaluateState();
         action.score = state.actionScore;
       } else {
-        bool foundNextBestAction = false;
-        doAlphaBeta(state, depth + 1, alpha, beta, !myTurn, foundNextBestAction, nextAction);
-        if (trace_debug)
-          cerr << string(3 * depth, ' ') << depth << ": best next action is " << nextAction.toString() << endl;
-        if (!foundNextBestAction) {
+        bool pruned = false;
+        if (futility && remaining == 1 && quiet) {
           state.evaluateState();
-          action.score = state.actionScore;
-        } else {
-          action.score = nextAction.score;
+          if (myTurn && state.actionScore + FUTILITY_MARGIN <= alpha) {
+            action.score = state.actionScore + FUTILITY_MARGIN;
+            pruned       = true;
+          } else if (!myTurn && state.actionScore - FUTILITY_MARGIN >= beta) {
+            action.score = state.actionScore - FUTILITY_MARGIN;
+            pruned       = true;
+          }
+        }
+        if (!pruned) {
+          // a reduced search lowers the horizon for the whole subtree below the move
+          int  reduction = (reductions && quiet && remaining >= 2 && index >= LMR_FIRST_MOVES ? 1 : 0);
+          bool full      = (reduction == 0);
+          if (!full) {
+            int a = alpha, b = beta;
+            if (research && myTurn) b = alpha + 1;
+            if (research && !myTurn) a = beta - 1;
+            depthMax -= reduction;
+            action.score = search(state, depth, a, b, myTurn, nextAction);
+            depthMax += reduction;
+            full = research && !aborted && (myTurn ? alpha < action.score : action.score < beta);
+          }
+          if (full && !aborted) action.score = search(state, depth, alpha, beta, myTurn, nextAction);
+        }
+        if (aborted) {
+          state.undoAction(action);
+          break;
         }
       }
+      index++;
 
       if (trace_debug) state.printState();
       state.undoAction(action);
@@ -533,8 +841,91 @@ struct AlphaBeta {
     if (trace_debug)
       cerr << string(3 * depth, ' ') << depth << ": return next action is " << bestAction.toString() << endl;
   }
+
+  // Score of the state reached by a move of the node at `depth`, searched down to depthMax
+  int search(State &state, int depth, int alpha, int beta, bool myTurn, Action &nextAction) {
+    bool foundNextBestAction = false;
+    doAlphaBeta(state, depth + 1, alpha, beta, !myTurn, foundNextBestAction, nextAction);
+    if (trace_debug)
+      cerr << string(3 * depth, ' ') << depth << ": best next action is " << nextAction.toString() << endl;
+    if (!foundNextBestAction) {
+      state.evaluateState();
+      return state.actionScore;
+    }
+    return nextAction.score;
+  }
 };
 
+// Reads the next turn of the referee into `state` and `actions`, false once the input is over. The turn's clock is
+// started as soon as its first row is in, when the referee starts timing us
+bool readTurn(istream &in, State &state, vector<Action> &actions, TurnBudget *budget) {
+  for (int i = 0; i < size; i++) {
+    string row;
+    if (!(in >> row)) return false;
+    in.ignore();
+    if (i == 0 && budget) budget->startTurn();
+    if (input_debug) cerr << row << endl;
+    for (int j = 0; j < size; j++) {
+      if (row[j] == '.') {
+        state.board[i * size + j].height = -1;
+      } else {
+        state.board[i * size + j].height = row[j] - '0';
+      }
+      state.board[i * size + j].unitIdx = -1;
+    }
+  }
+  for (int i = 0; i < 2 * unitsPerPlayer; i++) {
+    int x, y;
+    in >> x >> y;
+    in.ignore();
+    if (input_debug) cerr << x << " " << y << endl;
+    state.players[i] = {(int8_t)x, (int8_t)y};
+    if (state.players[i].x != -1)
+      state.board[state.players[i].x + size * state.players[i].y].unitIdx = i;
+  }
+
+  actions.clear();
+  int nbLegalActions;
+  in >> nbLegalActions;
+  in.ignore();
+  if (input_debug) cerr << nbLegalActions << endl;
+  for (int i = 0; i < nbLegalActions; i++) {
+    string atype;
+    int    index;
+    string dir1;
+    string dir2;
+    in >> atype >> index >> dir1 >> dir2;
+    in.ignore();
+    if (input_debug) cerr << atype << " " << index << " " << dir1 << " " << dir2 << endl;
+    Action action = Action(convertStringIntoActionType(atype),
+                           index,
+                           convertStringIntoDirection(dir1),
+                           convertStringIntoDirection(dir2));
+    actions.push_back(action);
+  }
+  return true;
+}
+
+// Iterative deepening: up to DEPTH whatever the time, then deeper until the budget runs out, keeping the result of
+// the last search that completed. Returns the depth of that search.
+int deepen(State &state, AlphaBeta &alphaBeta, TurnBudget &budget, bool &foundBest, Action &bestAction) {
+  int depth      = 1;
+  alphaBeta.nodes = 0;
+  for (; depth <= MAX_DEPTH; depth++) {
+    Action action;
+    bool   found       = false;
+    alphaBeta.depthMax = depth;
+    alphaBeta.budget   = (depth > DEPTH ? &budget : NULL);
+    alphaBeta.aborted  = false;
+    state.resetScore();
+    alphaBeta.doAlphaBeta(state, 1, -100000, 100000, true, found, action);
+    if (alphaBeta.aborted) break;
+    bestAction = action;
+    foundBest  = found;
+  }
+  return depth - 1;
+}
+
 /**
  * Auto-generated code below aims at helping you parse
  * the standard input according to the problem statement.
@@ -547,70 +938,52 @@ int main() {
   cin >> unitsPerPlayer;
   cin.ignore();
   if (input_debug) cerr << size << " " << unitsPerPlayer << endl;
-  State     state     = State();
-  AlphaBeta alphaBeta = AlphaBeta(DEPTH);
+  State      state     = State();
+  AlphaBeta  alphaBeta = AlphaBeta(DEPTH);
+  TurnBudget budget(FIRST_TURN_TIME, TURN_TIME, TURN_SAFETY);
+  Belief     belief;
 
   // game loop
   while (1) {
     turn++;
     // if (turn == 25) trace_debug = true;
-    for (int i = 0; i < size; i++) {
-      string row;
-      cin >> row;
-      cin.ignore();
-      if (input_debug) cerr << row << endl;
-      for (int j = 0; j < size; j++) {
-        if (row[j] == '.') {
-          state.board[i * size + j].height = -1;
-        } else {
-          state.board[i * size + j].height = row[j] - '0';
-        }
-        state.board[i * size + j].unitIdx = -1;
-      }
-    }
-    for (int i = 0; i < 2 * unitsPerPlayer; i++) {
-      cin >> state.players[i].first >> state.players[i].second;
-      cin.ignore();
-      if (input_debug) cerr << state.players[i].first << " " << state.players[i].second << endl;
-      if (state.players[i].first != -1)
-        state.board[state.players[i].first + size * state.players[i].second].unitIdx = i;
-    }
-
-    alphaBeta.initialActions.clear();
-    int nbLegalActions;
-    cin >> nbLegalActions;
-    cin.ignore();
-    if (input_debug) cerr << nbLegalActions << endl;
-    for (int i = 0; i < nbLegalActions; i++) {
-      string atype;
-      int    index;
-      string dir1;
-      string dir2;
-      cin >> atype >> index >> dir1 >> dir2;
-      cin.ignore();
-      if (input_debug) cerr << atype << " " << index << " " << dir1 << " " << dir2 << endl;
-      Action action = Action(convertStringIntoActionType(atype),
-                             index,
-                             convertStringIntoDirection(dir1),
-                             convertStringIntoDirection(dir2));
-      alphaBeta.initialActions.push_back(action);
-    }
-
+    if (!readTurn(cin, state, alphaBeta.initialActions, &budget)) return 0;
+    budget.inputParsed();
+    belief.update(state);
     if (alphaBeta.initialActions.size() == 0) {
       cout << "ACCEPT-DEFEAT" << endl;
       return 0;
     }
 
-    int alpha = -100000, beta = 100000;
-    state.resetScore();
+    // positions of the opening book are answered without searching
     Action bestAction;
-    bool   foundBest = false;
-    alphaBeta.doAlphaBeta(state, 1, alpha, beta, true, foundBest, bestAction);
+    if (bookMove(state, alphaBeta.initialActions, bestAction)) {
+      cerr << "BOOK" << endl;
+      bestAction.print();
+      belief.played(state, &bestAction);
+      budget.endTurn();
+      budget.report(cerr);
+      continue;
+    }
+
+    // the search sees the hidden units whose whereabouts are narrow enough
+    State searched = state;
+    int   placed   = belief.place(searched);
+    for (int u = unitsPerPlayer; u < 2 * unitsPerPlayer; u++) {
+      if (state.players[u].x == -1) cerr << "BELIEF unit=" << u << " cells=" << belief.count(u) << endl;
+    }
+
+    bool foundBest = false;
+    int  depth     = deepen(searched, alphaBeta, budget, foundBest, bestAction);
+    belief.played(state, foundBest ? &bestAction : NULL);
     if (!foundBest) {
       cout << "ACCEPT-DEFEAT" << endl;
     } else {
-      cerr << "SCORE=" << bestAction.score << endl;
+      cerr << "SCORE=" << bestAction.score << " depth=" << depth << " nodes=" << alphaBeta.nodes << " placed=" << placed
+           << endl;
       bestAction.print();
     }
+    budget.endTurn();
+    budget.report(cerr);
   }
 }
@@ -0,0 +1,245 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "turn_budget.h"
+#include "wondev_book.h"
+
+// The bot is compiled as is, its main() becomes ww::main. Every header it includes must be included above, so that
+// its own #include lines are no-ops inside the namespace.
+namespace ww {
+#include "wondev.cpp"
+}
+
+using namespace std;
+using namespace std::chrono;
+
+#define BOARD_SIZE (6)
+#define UNITS (2)
+#define HOLES (4)  // cells removed from the board, by point-symmetric pairs
+#define MAX_TURNS (200)
+
+// Headless referee for two-player Wondev Woman on the bot's own State, which already applies the moves, builds,
+// pushes and points. With fog, as in the live game, the opponent's units only show next to the player's own, otherwise
+// both players see everything. The referee lists the legal actions of the player to move, as the live one does, and
+// the game ends when that player has none or after MAX_TURNS actions, the most points winning.
+struct Referee {
+  ww::State world;  // units 0 and 1 are player 0's
+  uint32_t  state;
+  int       turn;
+
+  uint32_t random(uint32_t n) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state % n;
+  }
+
+  explicit Referee(uint32_t seed) : state(seed | 1), turn(0) {
+    int cells = BOARD_SIZE * BOARD_SIZE;
+    for (int c = 0; c < cells; c++) world.board[c].height = 0;
+    for (int h = 0; h < HOLES / 2; h++) {
+      int c                                = random(cells);
+      world.board[c].height                = -1;
+      world.board[cells - 1 - c].height    = -1;
+    }
+    for (int u = 0; u < UNITS; u++) {
+      int c;
+      do {
+        c = random(cells);
+      } while (world.board[c].height == -1 || world.board[c].unitIdx != -1 || world.board[cells - 1 - c].unitIdx != -1 ||
+               c == cells - 1 - c);
+      place(u, c);
+      place(UNITS + u, cells - 1 - c);
+    }
+  }
+
+  void place(int unit, int c) {
+    world.board[c].unitIdx = unit;
+    world.players[unit]    = {(int8_t)(c % BOARD_SIZE), (int8_t)(c / BOARD_SIZE)};
+  }
+
+  bool isFree(int x, int y) {
+    return x != -1 && world.board[x + BOARD_SIZE * y].height >= 0 && world.board[x + BOARD_SIZE * y].height < 4 &&
+           world.board[x + BOARD_SIZE * y].unitIdx == -1;
+  }
+
+  // Legal actions of `player`: move to a free neighbour at most a floor higher and build next to it, or push an
+  // enemy neighbour away from the unit, to a free cell at most a floor higher than the enemy's, and build where it was
+  void legalActions(int player, vector<ww::Action> &actions) {
+    actions.clear();
+    for (int u = player * UNITS; u < (player + 1) * UNITS; u++) {
+      int x = world.players[u].x, y = world.players[u].y;
+      int height = world.board[x + BOARD_SIZE * y].height;
+      for (int dir1 = 0; dir1 < ww::DIR_MAX; dir1++) {
+        int x2 = x, y2 = y;
+        ww::getNewPosition(x2, y2, dir1);
+        if (x2 == -1) continue;
+        ww::Cell &next = world.board[x2 + BOARD_SIZE * y2];
+        if (isFree(x2, y2) && next.height <= height + 1) {
+          world.board[x + BOARD_SIZE * y].unitIdx = -1;
+          for (int dir2 = 0; dir2 < ww::DIR_MAX; dir2++) {
+            int x3 = x2, y3 = y2;
+            ww::getNewPosition(x3, y3, dir2);
+            if (isFree(x3, y3)) actions.push_back(ww::Action(ww::MOVE_BUILD, u, dir1, dir2));
+          }
+          world.board[x + BOARD_SIZE * y].unitIdx = u;
+        }
+        if (next.unitIdx / UNITS == 1 - player && next.unitIdx != -1) {
+          for (int d = dir1 + 7; d <= dir1 + 9; d++) {
+            int x3 = x2, y3 = y2;
+            ww::getNewPosition(x3, y3, d % 8);
+            if (isFree(x3, y3) && world.board[x3 + BOARD_SIZE * y3].height <= next.height + 1) {
+              actions.push_back(ww::Action(ww::PUSH_BUILD, u, dir1, d % 8));
+            }
+          }
+        }
+      }
+    }
+  }
+};
+
+// The world as seen by player `me`: its units come first and its points are myScore
+ww::State view(const ww::State &world, int me) {
+  if (me == 0) return world;
+  ww::State v = world;
+  for (int u = 0; u < 2 * UNITS; u++) v.players[(u + UNITS) % (2 * UNITS)] = world.players[u];
+  for (auto &cell : v.board) {
+    if (cell.unitIdx != -1) cell.unitIdx = (cell.unitIdx + UNITS) % (2 * UNITS);
+  }
+  swap(v.myScore, v.otherScore);
+  return v;
+}
+
+// Hides the opponent's units out of sight of the player's own in a view
+void hide(ww::State &v) {
+  for (int u = UNITS; u < 2 * UNITS; u++) {
+    bool seen = false;
+    for (int m = 0; m < UNITS; m++) {
+      seen |= (abs(v.players[u].x - v.players[m].x) <= 1 && abs(v.players[u].y - v.players[m].y) <= 1);
+    }
+    if (seen) continue;
+    v.board[v.players[u].x + BOARD_SIZE * v.players[u].y].unitIdx = -1;
+    v.players[u]                                                   = {-1, -1};
+  }
+}
+
+struct Results {
+  int       games, moves;
+  double    wins, score, depth;
+  long long hidden, tracked, cells;  // hidden units met, of which in their belief, and belief sizes
+  Results() : games(0), moves(0), wins(0), score(0), depth(0), hidden(0), tracked(0), cells(0) {}
+};
+
+// Play game number g between the techniques of configs[0] and configs[1], who moves first alternating with g. A
+// configuration naming "belief" tracks the hidden units and puts them in its search.
+void playGame(const vector<string> &configs, int g, double moveTime, bool fog, vector<Results> &results, mutex &lock) {
+  Referee       referee(1000003u * (g / 2) + 12345u);
+  ww::AlphaBeta bots[2];
+  ww::Belief    beliefs[2];
+  bool          tracking[2];
+  int           seat[2] = {g % 2, 1 - g % 2};
+  double        depth[2] = {0, 0};
+  int           moves[2] = {0, 0};
+  long long     hidden[2] = {0, 0}, tracked[2] = {0, 0}, cells[2] = {0, 0};
+  for (int p = 0; p < 2; p++) {
+    bots[p].select(configs[seat[p]]);
+    tracking[p] = (configs[seat[p]].find("belief") != string::npos);
+  }
+
+  vector<ww::Action> legal;
+  for (; referee.turn < MAX_TURNS; referee.turn++) {
+    int p = referee.turn % 2;
+    referee.legalActions(p, legal);
+    if (legal.empty()) break;
+    for (auto &action : legal) {
+      if (p == 1) action.index = (action.index + UNITS) % (2 * UNITS);
+    }
+    ww::State truth = view(referee.world, p), v = truth;
+    if (fog) hide(v);
+    ww::State searched = v;
+    if (tracking[p]) {
+      beliefs[p].update(v);
+      beliefs[p].place(searched);
+      for (int u = UNITS; u < 2 * UNITS; u++) {
+        if (v.players[u].x != -1) continue;
+        hidden[p]++;
+        tracked[p] += (beliefs[p].possible[u] >> (truth.players[u].x + BOARD_SIZE * truth.players[u].y) & 1);
+        cells[p] += beliefs[p].count(u);
+      }
+    }
+    TurnBudget budget(moveTime, moveTime, 0);
+    budget.startTurn();
+    bots[p].initialActions = legal;
+    ww::Action best;
+    bool       found = false;
+    depth[p] += ww::deepen(searched, bots[p], budget, found, best);
+    moves[p]++;
+    if (tracking[p]) beliefs[p].played(v, &best);
+    if (p == 1) best.index = (best.index + UNITS) % (2 * UNITS);
+    referee.world.applyAction(best);
+  }
+
+  int               points[2] = {referee.world.myScore, referee.world.otherScore};
+  lock_guard<mutex> guard(lock);
+  for (int p = 0; p < 2; p++) {
+    Results &r = results[seat[p]];
+    r.games++;
+    r.score += points[p];
+    r.depth += depth[p];
+    r.moves += moves[p];
+    r.hidden += hidden[p];
+    r.tracked += tracked[p];
+    r.cells += cells[p];
+    r.wins += (points[p] > points[1 - p] ? 1 : points[p] == points[1 - p] ? 0.5 : 0);
+  }
+}
+
+// Self-play between two sets of selective search techniques (see AlphaBeta::select), on the same boards from both
+// seats: games g and g + 1 share their board and swap who moves first. Fog hides the units out of sight.
+int main(int argc, char const *argv[]) {
+  int            nbGame   = (argc > 1 ? atoi(argv[1]) : 100);
+  int            nbThread = (argc > 2 ? atoi(argv[2]) : max(1u, thread::hardware_concurrency()));
+  double         moveTime = (argc > 3 ? atof(argv[3]) : 0.01);
+  vector<string> configs  = {"order,lmr,futility,research", "plain"};
+  for (int p = 0; p < 2 && 4 + p < argc; p++) configs[p] = argv[4 + p];
+  bool fog = (argc > 6 && atoi(argv[6]) != 0);
+  ww::size           = BOARD_SIZE;
+  ww::unitsPerPlayer = UNITS;
+  ww::input_debug    = false;
+
+  vector<Results> results(2);
+  mutex           lock;
+  atomic<int>     next(0);
+  auto            start = high_resolution_clock::now();
+  vector<thread>  threads;
+  for (int t = 0; t < nbThread; t++) {
+    threads.push_back(thread([&]() {
+      for (int g = next++; g < nbGame; g = next++) playGame(configs, g, moveTime, fog, results, lock);
+    }));
+  }
+  for (auto &t : threads) t.join();
+  duration<double> elapsed = high_resolution_clock::now() - start;
+
+  cout << nbGame << " games in " << fixed << setprecision(1) << elapsed.count() << "s (" << nbThread << " threads, "
+       << moveTime * 1e3 << "ms a move" << (fog ? ", fog" : "") << ")" << endl;
+  cout << "config,games,win_rate,mean_score,mean_depth,belief_hit_rate,belief_cells" << endl;
+  for (int c = 0; c < 2; c++) {
+    Results &r = results[c];
+    cout << configs[c] << "," << r.games << "," << setprecision(3) << r.wins / max(1, r.games) << ","
+         << setprecision(2) << r.score / max(1, r.games) << "," << r.depth / max(1, r.moves) << ","
+         << setprecision(3) << (double)r.tracked / max(1LL, r.hidden) << "," << setprecision(2)
+         << (double)r.cells / max(1LL, r.hidden) << endl;
+  }
+  return 0;
+}
@@ -0,0 +1,144 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "turn_budget.h"
+#include "wondev_book.h"
+
+// The bot is compiled as is, its main() becomes ww::main. Every header it includes must be included above, so that
+// its own #include lines are no-ops inside the namespace.
+namespace ww {
+#include "wondev.cpp"
+}
+
+using namespace std;
+using namespace std::chrono;
+
+static volatile long long sink;
+
+struct Position {
+  ww::State           state;
+  vector<ww::Action> actions;
+};
+
+// Every turn of a recorded game, as the referee sent it to the bot
+vector<Position> load(const char *path) {
+  ifstream         in(path);
+  vector<Position> positions;
+  in >> ww::size >> ww::unitsPerPlayer;
+  ww::input_debug = false;
+  Position position;
+  while (ww::readTurn(in, position.state, position.actions, NULL)) {
+    if (!position.actions.empty()) positions.push_back(position);
+  }
+  return positions;
+}
+
+template <typename kernel_function>
+double nanosPerChild(vector<Position> &positions, int rounds, kernel_function &&kernel, long long &checksum) {
+  long long children = 0;
+  auto      start    = high_resolution_clock::now();
+  for (int r = 0; r < rounds; r++) {
+    for (auto &position : positions) {
+      for (auto &action : position.actions) checksum += kernel(position.state, action);
+      children += position.actions.size();
+    }
+  }
+  duration<double, nano> elapsed = high_resolution_clock::now() - start;
+  return elapsed.count() / children;
+}
+
+// Copy-make against make/unmake on the positions of wondev_input: cost of expanding one child either way, then of
+// whole fixed-depth searches, copy-make Minimax against make/unmake AlphaBeta. Last, the depth the iterative deepening
+// of AlphaBeta reaches in a fixed time with each set of selective search techniques.
+int main(int argc, char const *argv[]) {
+  const char *path     = (argc > 1 ? argv[1] : "wondev_input");
+  int         rounds   = (argc > 2 ? atoi(argv[2]) : 2000);
+  int         depth    = (argc > 3 ? atoi(argv[3]) : 3);
+  double      timeSpan = (argc > 4 ? atof(argv[4]) : 0.04);
+
+  vector<Position> positions = load(path);
+  if (positions.empty()) {
+    cerr << "no position in " << path << endl;
+    return 1;
+  }
+  cout << positions.size() << " positions, State is " << sizeof(ww::State) << " bytes, "
+       << (is_trivially_copyable<ww::State>::value ? "" : "not ") << "trivially copyable" << endl;
+
+  long long checksum  = 0;
+  auto      copyMake  = [](ww::State &state, ww::Action &action) {
+    ww::State child = state;
+    child.applyAction(action);
+    child.evaluateState();
+    return child.actionScore;
+  };
+  auto makeUnmake = [](ww::State &state, ww::Action &action) {
+    state.applyAction(action);
+    state.evaluateState();
+    int score = state.actionScore;
+    state.undoAction(action);
+    return score;
+  };
+  double copyTime   = nanosPerChild(positions, rounds, copyMake, checksum);
+  double unmakeTime = nanosPerChild(positions, rounds, makeUnmake, checksum);
+
+  double minimaxTime = 0, alphaBetaTime = 0;
+  for (auto &position : positions) {
+    ww::Minimax minimax(depth);
+    minimax.initialActions = position.actions;
+    auto start             = high_resolution_clock::now();
+    ww::Action *best       = minimax.doMinimax(position.state, 1, true);
+    minimaxTime += duration<double, milli>(high_resolution_clock::now() - start).count();
+    checksum += (best ? best->score : 0);
+
+    ww::AlphaBeta alphaBeta(depth);
+    alphaBeta.initialActions = position.actions;
+    ww::Action action;
+    bool       found = false;
+    start            = high_resolution_clock::now();
+    alphaBeta.doAlphaBeta(position.state, 1, -100000, 100000, true, found, action);
+    alphaBetaTime += duration<double, milli>(high_resolution_clock::now() - start).count();
+    checksum += action.score;
+  }
+
+  cout << "copy_make_ns,make_unmake_ns,minimax_ms,alphabeta_ms" << endl;
+  cout << fixed << setprecision(1) << copyTime << "," << unmakeTime << "," << setprecision(3)
+       << minimaxTime / positions.size() << "," << alphaBetaTime / positions.size() << defaultfloat << endl;
+
+  cout << "techniques,mean_depth,min_depth,max_depth,knodes_per_move,same_move" << endl;
+  vector<ww::Action> reference;
+  for (string techniques : {"plain", "order", "order,lmr", "order,lmr,research", "order,futility",
+                            "order,lmr,futility,research"}) {
+    double sumDepth = 0, nodes = 0;
+    int    minDepth = MAX_DEPTH, maxDepth = 0, same = 0;
+    for (size_t p = 0; p < positions.size(); p++) {
+      ww::AlphaBeta alphaBeta;
+      alphaBeta.select(techniques);
+      alphaBeta.initialActions = positions[p].actions;
+      TurnBudget budget(timeSpan, timeSpan, 0);
+      budget.startTurn();
+      ww::Action best;
+      bool       found = false;
+      int        d     = ww::deepen(positions[p].state, alphaBeta, budget, found, best);
+      sumDepth += d;
+      minDepth = min(minDepth, d);
+      maxDepth = max(maxDepth, d);
+      nodes += alphaBeta.nodes;
+      if (reference.size() < positions.size()) reference.push_back(best);
+      same += (best.atype == reference[p].atype && best.index == reference[p].index &&
+               best.dir1 == reference[p].dir1 && best.dir2 == reference[p].dir2);
+    }
+    cout << techniques << "," << setprecision(2) << fixed << sumDepth / positions.size() << "," << minDepth << ","
+         << maxDepth << "," << nodes / positions.size() / 1e3 << "," << same << defaultfloat << endl;
+  }
+  sink = checksum;
+  return 0;
+}
@@ -0,0 +1,138 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "turn_budget.h"
+#include "wondev_book.h"
+
+// The bot is compiled as is, its main() becomes ww::main. Every header it includes must be included above, so that
+// its own #include lines are no-ops inside the namespace.
+namespace ww {
+#include "wondev.cpp"
+}
+
+using namespace std;
+
+struct Entry {
+  uint64_t  key;
+  ww::State state;
+  int       symmetry;
+  uint16_t  move;
+  int       depth;
+};
+
+// First-turn positions of a flat board: every placement of our units, the opponent's hidden as the referee sends
+// them, and `builds` cells already raised to 1 by an opponent who played first. Kept once per symmetry class.
+void enumerate(int builds, vector<Entry> &entries) {
+  map<uint64_t, Entry> unique;
+  int                  cells = ww::size * ww::size;
+  vector<int>          chosen;
+  function<void(int)>  place = [&](int from) {
+    if ((int)chosen.size() == ww::unitsPerPlayer + builds) {
+      Entry entry;
+      for (int c = 0; c < cells; c++) entry.state.board[c].height = 0;
+      for (int u = 0; u < 2 * ww::unitsPerPlayer; u++) entry.state.players[u] = {-1, -1};
+      for (int u = 0; u < ww::unitsPerPlayer; u++) {
+        entry.state.players[u]                  = {(int8_t)(chosen[u] % ww::size), (int8_t)(chosen[u] / ww::size)};
+        entry.state.board[chosen[u]].unitIdx = u;
+      }
+      for (int b = ww::unitsPerPlayer; b < (int)chosen.size(); b++) entry.state.board[chosen[b]].height = 1;
+      entry.key = ww::canonicalHash(entry.state, entry.symmetry);
+      unique.insert(make_pair(entry.key, entry));
+      return;
+    }
+    // units are interchangeable, and so are builds, but a build may not be under a unit
+    int start = ((int)chosen.size() == ww::unitsPerPlayer ? 0 : from);
+    for (int c = start; c < cells; c++) {
+      if (find(chosen.begin(), chosen.end(), c) != chosen.end()) continue;
+      chosen.push_back(c);
+      place(c + 1);
+      chosen.pop_back();
+    }
+  };
+  place(0);
+  for (auto &kv : unique) entries.push_back(kv.second);
+}
+
+// Searches every entry for `seconds` with the bot's own iterative deepening, on `nbThread` threads
+void solve(vector<Entry> &entries, double seconds, int nbThread) {
+  atomic<size_t> next(0);
+  vector<thread> threads;
+  for (int t = 0; t < nbThread; t++) {
+    threads.push_back(thread([&]() {
+      for (size_t e = next++; e < entries.size(); e = next++) {
+        Entry        &entry = entries[e];
+        ww::AlphaBeta alphaBeta(DEPTH);
+        entry.state.computePossibleActions(alphaBeta.initialActions, true);
+        TurnBudget budget(seconds, seconds, 0);
+        budget.startTurn();
+        ww::Action best;
+        bool       found = false;
+        entry.depth      = ww::deepen(entry.state, alphaBeta, budget, found, best);
+        entry.move       = (found ? ww::encodeBookMove(entry.state, entry.symmetry, best) : UINT16_MAX);
+      }
+    }));
+  }
+  for (auto &t : threads) t.join();
+}
+
+// Offline generator of wondev_book.h: specs are SIZExUNITS[+BUILDS], e.g. 5x2 or 5x2+1
+int main(int argc, char const *argv[]) {
+  double seconds  = (argc > 1 ? atof(argv[1]) : 5);
+  int    nbThread = (argc > 2 ? atoi(argv[2]) : max(1u, thread::hardware_concurrency()));
+  string output   = (argc > 3 ? argv[3] : "wondev_book.h");
+  vector<string> specs;
+  for (int i = 4; i < argc; i++) specs.push_back(argv[i]);
+  if (specs.empty()) specs.push_back("5x2");
+  ww::input_debug = false;
+
+  vector<Entry> book;
+  for (auto &spec : specs) {
+    int builds = 0;
+    if (sscanf(spec.c_str(), "%dx%d+%d", &ww::size, &ww::unitsPerPlayer, &builds) < 2 || ww::size > MAX_SIZE ||
+        ww::size < 1 || ww::unitsPerPlayer > MAX_UNITS / 2 || ww::unitsPerPlayer < 1) {
+      cerr << "bad spec " << spec << endl;
+      return 1;
+    }
+    vector<Entry> entries;
+    enumerate(builds, entries);
+    solve(entries, seconds, nbThread);
+    double depth = 0;
+    for (auto &entry : entries) {
+      depth += entry.depth;
+      if (entry.move != UINT16_MAX) book.push_back(entry);
+    }
+    cerr << spec << ": " << entries.size() << " positions, mean depth " << fixed << setprecision(2)
+         << depth / max((size_t)1, entries.size()) << defaultfloat << endl;
+  }
+  sort(book.begin(), book.end(), [](const Entry &a, const Entry &b) { return a.key < b.key; });
+
+  ofstream out(output);
+  out << "#ifndef WONDEV_BOOK_H\n#define WONDEV_BOOK_H\n\n#include <cstdint>\n\n";
+  out << "// Opening book of wondev.cpp, generated by codingame_ww_book: do not edit.\n";
+  out << "// Canonical Zobrist hashes of the positions, sorted, and their moves packed as cell | type << 6 | dir1 << 7 "
+         "| dir2 << 10\n";
+  out << "// " << seconds << "s a position:";
+  for (auto &spec : specs) out << " " << spec;
+  out << "\n#define BOOK_ENTRIES (" << max((size_t)1, book.size()) << ")\n";
+  out << "static const uint64_t bookKeys[BOOK_ENTRIES] = {";
+  for (size_t e = 0; e < book.size(); e++) out << (e % 4 ? " " : "\n    ") << book[e].key << "ULL,";
+  if (book.empty()) out << "UINT64_MAX";
+  out << "\n};\nstatic const uint16_t bookMoves[BOOK_ENTRIES] = {";
+  for (size_t e = 0; e < book.size(); e++) out << (e % 12 ? " " : "\n    ") << book[e].move << ",";
+  if (book.empty()) out << "0";
+  out << "\n};\n\n#endif\n";
+  cerr << book.size() << " entries written to " << output << endl;
+  return 0;
+}
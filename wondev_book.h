@@ -0,0 +1,335 @@
+#ifndef WONDEV_BOOK_H
+#define WONDEV_BOOK_H
+
+#include <cstdint>
+
+// Opening book of wondev.cpp, generated by codingame_ww_book: do not edit.
+// Canonical Zobrist hashes of the positions, sorted, and their moves packed as cell | type << 6 | dir1 << 7 | dir2 << 10
+// 1.5s a position: 5x1 5x2 5x2+1
+#define BOOK_ENTRIES (959)
+static const uint64_t bookKeys[BOOK_ENTRIES] = {
+    5167600117663297ULL, 5280324261751226ULL, 5629904416701560ULL, 8595606479706231ULL,
+    15433936859349695ULL, 17162363911205579ULL, 17362602019081844ULL, 19110017235300514ULL,
+    19171769567406966ULL, 19917318565943578ULL, 20766613194568510ULL, 23252478322455717ULL,
+    23350066320976355ULL, 34689239716082820ULL, 36485794398293944ULL, 39345499216619713ULL,
+    40005233905515121ULL, 40055463289989992ULL, 41029954287581256ULL, 44579216966222399ULL,
+    45172388277542423ULL, 47155131912009231ULL, 47383238920917727ULL, 52698040743898941ULL,
+    54233331055241394ULL, 58852773248021590ULL, 62776154863805289ULL, 64877940956130702ULL,
+    68629294284879263ULL, 71710714839000510ULL, 71764092034829550ULL, 72334802805032754ULL,
+    73148363826967801ULL, 74092678251200361ULL, 75309864397846641ULL, 81015724751640014ULL,
+    83925036889254302ULL, 85974854703964484ULL, 89927867358014772ULL, 90376108268719048ULL,
+    91383297430697581ULL, 93921269234979060ULL, 96150774418201567ULL, 102846063064886026ULL,
+    103829562604728095ULL, 104064695717761952ULL, 106239605251777975ULL, 107050592187598520ULL,
+    109075758480075363ULL, 111435987097724086ULL, 111456526011400032ULL, 113555641940015671ULL,
+    115060909257907017ULL, 119594766717751236ULL, 120244219036470501ULL, 121102197991304074ULL,
+    121624455690254773ULL, 125513397243638462ULL, 127449737713168239ULL, 128534027894920008ULL,
+    134135850957166883ULL, 136994914478188872ULL, 141719857419994262ULL, 143038628222829676ULL,
+    145540426357219326ULL, 149080140193801023ULL, 149350649630024938ULL, 150916748423253603ULL,
+    151547072192315280ULL, 164395302197270507ULL, 166300081302327941ULL, 166474832252930482ULL,
+    166547985655056303ULL, 168486331628493380ULL, 175930196378207422ULL, 181125696236025934ULL,
+    184197929739348443ULL, 186094061129537777ULL, 189273413749566351ULL, 190532228360467539ULL,
+    192165704144971049ULL, 194266493031853043ULL, 198640344719318122ULL, 201442158996261384ULL,
+    202601996079139524ULL, 206406393580562269ULL, 209539281659965308ULL, 225984857970080462ULL,
+    230293613080236990ULL, 230459457624142810ULL, 232795351432015005ULL, 234147441263827125ULL,
+    234981643847809442ULL, 239183247231332597ULL, 240512800453789870ULL, 245357547009579813ULL,
+    246321268944282821ULL, 250159110250653078ULL, 252120009710942759ULL, 252540826690635411ULL,
+    252912065752165295ULL, 256549537658146546ULL, 259492439249593487ULL, 264627008030727973ULL,
+    264952898429767390ULL, 267131806212372312ULL, 267412065739325428ULL, 271465759827411629ULL,
+    273387616553994361ULL, 274393573371685576ULL, 281616645714521357ULL, 283126009448417094ULL,
+    284129244688955528ULL, 285860424727079535ULL, 286622483690508405ULL, 287781560992202840ULL,
+    291848577225897763ULL, 295010106532017342ULL, 295379158264967224ULL, 301150329499451299ULL,
+    303079618727977544ULL, 304987393199230624ULL, 307750710223192655ULL, 308090951481251951ULL,
+    309638214278963478ULL, 309692692319160390ULL, 319385102262689786ULL, 319551590309053704ULL,
+    319606992429802132ULL, 322713062775920017ULL, 325116977012014241ULL, 325654186786957173ULL,
+    332220883052705150ULL, 333601652257846235ULL, 334359789222421606ULL, 336131634067782433ULL,
+    338571279253537259ULL, 339318423510558745ULL, 344748818967028396ULL, 353349533455348444ULL,
+    356283140886812008ULL, 357534466656558169ULL, 365452214470793422ULL, 376700985328523069ULL,
+    376961426618160059ULL, 384071460104924640ULL, 385438200199320721ULL, 388209653485908623ULL,
+    392525904746753643ULL, 393637941546625764ULL, 396534112969393816ULL, 398369648913680140ULL,
+    399338576919316259ULL, 401533034079931400ULL, 403317417130797937ULL, 404757066378008325ULL,
+    407052983561976481ULL, 409408073389120107ULL, 412995560806437231ULL, 415735169989636940ULL,
+    420909362856824660ULL, 426682469461771689ULL, 434703308421194118ULL, 435584821459301068ULL,
+    446943975619150878ULL, 453693277899822534ULL, 453787116324814302ULL, 457858694579727316ULL,
+    459963978038544545ULL, 463041092056564028ULL, 465345124756667428ULL, 465652511524045940ULL,
+    466348947938228015ULL, 466509868021845664ULL, 467908655546671539ULL, 471120660238484818ULL,
+    473151539602881559ULL, 473306605014846867ULL, 479511023841781199ULL, 480357132210830035ULL,
+    487458891694194710ULL, 492450554557231933ULL, 496624973832687223ULL, 499178580333757416ULL,
+    500669856340923316ULL, 500742300266024240ULL, 502069925798739015ULL, 502334397586844648ULL,
+    503852380074993032ULL, 510820849539445386ULL, 515831663249067174ULL, 521671079295141794ULL,
+    529817320442046885ULL, 533595770845628287ULL, 533858114158579426ULL, 536801007033119693ULL,
+    538618061290966225ULL, 543297532354814273ULL, 554881259268395079ULL, 555606483687688835ULL,
+    559906371772195092ULL, 561288134277095704ULL, 562486016475342061ULL, 566645801216819853ULL,
+    568528847209725055ULL, 569666983491279800ULL, 574432630131445602ULL, 574693323683564516ULL,
+    575391066786067437ULL, 575698980619652971ULL, 577943237808744217ULL, 584459128017489764ULL,
+    585822621833778921ULL, 585878871791653271ULL, 595254938293569370ULL, 596173215874463996ULL,
+    599837237742808270ULL, 602419083857028634ULL, 603991617852533460ULL, 605736713174168110ULL,
+    606143502084904292ULL, 606428357237284296ULL, 606592157939931709ULL, 606604106370890149ULL,
+    608077905038264463ULL, 608602600676844622ULL, 608928550128481717ULL, 624859524639629864ULL,
+    627369715334866217ULL, 628403032592729160ULL, 632680362295438494ULL, 637161283770164618ULL,
+    637483727156595952ULL, 640850006898176551ULL, 644246752961000774ULL, 654148661354173997ULL,
+    660661551760533041ULL, 660686918544571879ULL, 664020683146135020ULL, 665910220011408202ULL,
+    668337142086168601ULL, 669168462492220109ULL, 671162793405469360ULL, 680519742618604848ULL,
+    689278429616663871ULL, 690754055674804477ULL, 700082515812879999ULL, 703099257745208359ULL,
+    721147401868385234ULL, 723713356199705438ULL, 725530311461423858ULL, 733131806531807871ULL,
+    736303238332554069ULL, 736692234015835625ULL, 747555094265724203ULL, 751062729751870538ULL,
+    761218590268042536ULL, 762640027501288754ULL, 763219944871586129ULL, 770754004770946491ULL,
+    772652498908342296ULL, 774811316512620382ULL, 778285050805036634ULL, 784980167532362557ULL,
+    797986974397772490ULL, 799772585798652946ULL, 807529561667331721ULL, 808662498337042303ULL,
+    812453505552439861ULL, 815675100014618018ULL, 816476526608646737ULL, 820971915241774076ULL,
+    822339512726889101ULL, 824293621128524261ULL, 830937099330462174ULL, 832569547493711413ULL,
+    838588053271325375ULL, 844705590155656184ULL, 850378173412535505ULL, 850546991888761642ULL,
+    851886028273013471ULL, 852473441909071553ULL, 865356110748182557ULL, 869519752358661757ULL,
+    874870342927072804ULL, 877355577530899607ULL, 880630253274345768ULL, 885700709584859414ULL,
+    888708503852534737ULL, 889115241433102150ULL, 894588282068033800ULL, 901195715528531177ULL,
+    902188449474872117ULL, 904072042438949425ULL, 905202665670839699ULL, 909244510607213876ULL,
+    909760206986962820ULL, 916705794173611503ULL, 931948410777133746ULL, 934470246444115510ULL,
+    938712144449790960ULL, 939150129874134483ULL, 944501137850308141ULL, 944520581142890558ULL,
+    946300239202918627ULL, 950916042028504409ULL, 960585808665090097ULL, 960587071811666919ULL,
+    961446865198279668ULL, 963179699898387756ULL, 969944982563934275ULL, 975136205636239259ULL,
+    978215071582082894ULL, 978594173145235286ULL, 980625126756616938ULL, 990056739071304241ULL,
+    992665372646382426ULL, 994689065015592375ULL, 994741768806858396ULL, 996647880965816627ULL,
+    997500351444547379ULL, 998150131205635128ULL, 1003225144109345328ULL, 1005608686104900785ULL,
+    1011096887015679428ULL, 1011727073418727884ULL, 1016724015138602634ULL, 1020378188571991043ULL,
+    1022696350698869954ULL, 1023615522136321849ULL, 1028969826689352161ULL, 1031994621846964965ULL,
+    1035513947200259614ULL, 1040894394639331579ULL, 1042349247356246905ULL, 1044340716811007848ULL,
+    1046282877776344749ULL, 1049542352571323286ULL, 1059643548601209074ULL, 1067829735902376502ULL,
+    1069192925882604837ULL, 1069995453481839352ULL, 1071440278072572130ULL, 1073532756737540104ULL,
+    1092485898255267529ULL, 1096535955547671154ULL, 1103105209123550729ULL, 1104179761330526206ULL,
+    1105658309687367219ULL, 1110475863935052346ULL, 1115516979903269529ULL, 1126952341425540139ULL,
+    1130442452463164683ULL, 1136622693568404136ULL, 1137290919035197363ULL, 1141800783327283956ULL,
+    1143340821256975101ULL, 1144784009703334154ULL, 1146377165917421684ULL, 1147961495915081220ULL,
+    1149151518988653875ULL, 1149538788015796574ULL, 1151183655065661849ULL, 1162149457274990736ULL,
+    1163012660961488707ULL, 1163904648488458446ULL, 1173141511260106347ULL, 1178977076917182273ULL,
+    1179270040793060737ULL, 1180711729161569051ULL, 1182959077090158300ULL, 1183759726061603279ULL,
+    1184341125805406826ULL, 1186443187727672555ULL, 1190474960678243068ULL, 1195647814151890448ULL,
+    1205508065439166008ULL, 1211349050449958634ULL, 1212362140564534022ULL, 1217760701214788493ULL,
+    1223445687865946919ULL, 1224599791462738836ULL, 1225591087569459712ULL, 1227963873289047808ULL,
+    1230863671271189061ULL, 1232451953179398706ULL, 1236720126422909133ULL, 1237508240013214778ULL,
+    1241623684291914079ULL, 1242807935928851726ULL, 1244905600547114599ULL, 1247116088491437770ULL,
+    1251314149134647117ULL, 1254897095049017765ULL, 1254913330204370093ULL, 1255724958992405716ULL,
+    1267602443093240502ULL, 1276702328174400076ULL, 1283085625262589194ULL, 1287444868613153239ULL,
+    1290009228794757178ULL, 1290310630850761523ULL, 1291446900768638989ULL, 1292540492950475779ULL,
+    1300688526610101201ULL, 1302038598363488234ULL, 1302476162253486090ULL, 1306005039830557843ULL,
+    1313523540759876747ULL, 1314542990381684703ULL, 1315191288930248958ULL, 1315679191394871536ULL,
+    1324066556497815434ULL, 1326529240663261061ULL, 1328120574598959870ULL, 1329551220489096879ULL,
+    1330071360575643871ULL, 1337599548431196186ULL, 1344361894626681864ULL, 1346634800762883098ULL,
+    1352938877327133199ULL, 1353331241748835520ULL, 1353356882590191467ULL, 1355685187608680018ULL,
+    1356518556225257025ULL, 1358711026805344976ULL, 1360012320238855169ULL, 1361031011014709495ULL,
+    1361541548629299719ULL, 1367287867112000309ULL, 1370602947211741532ULL, 1373208016292254569ULL,
+    1373444087074687387ULL, 1374292082431919663ULL, 1377287477547118810ULL, 1377565495107958902ULL,
+    1380611843188980679ULL, 1381840765008905953ULL, 1382997236767299054ULL, 1385910436141570888ULL,
+    1386026443611633754ULL, 1387268695966067343ULL, 1393048653100807209ULL, 1397214340060948749ULL,
+    1406629089201761792ULL, 1413599419576377130ULL, 1418094161903939996ULL, 1420007441853859935ULL,
+    1421346542428556811ULL, 1432944280852638400ULL, 1433604634657157396ULL, 1439985911159134353ULL,
+    1442971494233875333ULL, 1444528172502394399ULL, 1446001903822985648ULL, 1447563668439660418ULL,
+    1450376809691795452ULL, 1452476789528807799ULL, 1466907427332050653ULL, 1479138717029363853ULL,
+    1484941792718259732ULL, 1485537279817122215ULL, 1487784074401027276ULL, 1491101148086204346ULL,
+    1492218787343869224ULL, 1492439697971496428ULL, 1497281409368679702ULL, 1500368367942251542ULL,
+    1502088808229954164ULL, 1503451489470709442ULL, 1520792441345992290ULL, 1524702615171531034ULL,
+    1526947126712085747ULL, 1528388472472031367ULL, 1528465704550186401ULL, 1528776898167983141ULL,
+    1532332376541282859ULL, 1538174749373131670ULL, 1543697903643108089ULL, 1546065515888503135ULL,
+    1549044252472936662ULL, 1560629051223719882ULL, 1562182214909544387ULL, 1574170613756551173ULL,
+    1576244343981674620ULL, 1577460300814434835ULL, 1580113166358636580ULL, 1581127818665399059ULL,
+    1584263948190771810ULL, 1585530042704247575ULL, 1592210809336230870ULL, 1593582548411191513ULL,
+    1597783864904976021ULL, 1601582619986388204ULL, 1612613085008122195ULL, 1622751570100682535ULL,
+    1629120480238814108ULL, 1634762566597011538ULL, 1635311533837465160ULL, 1638388582111024560ULL,
+    1645014115224154077ULL, 1649417061851966132ULL, 1650356546182443760ULL, 1653583372863843414ULL,
+    1654414699083761138ULL, 1656623204600578908ULL, 1660518165731976179ULL, 1660691407618898852ULL,
+    1665452197598229812ULL, 1668500982623510218ULL, 1681953570722864657ULL, 1686117929387959151ULL,
+    1693610362643170138ULL, 1696015247532564448ULL, 1702569073517658759ULL, 1706043946714490595ULL,
+    1706485245150481375ULL, 1709369192879678617ULL, 1711048470491329800ULL, 1713730342324182604ULL,
+    1715601723916136193ULL, 1717968088360438422ULL, 1725542024535944743ULL, 1727640447070304358ULL,
+    1729949069446715795ULL, 1736620523261311408ULL, 1737256494359742531ULL, 1739224138340743964ULL,
+    1742575605727682664ULL, 1743180594501492534ULL, 1744085229291604825ULL, 1750883115949588879ULL,
+    1758111078730084219ULL, 1768055264893294101ULL, 1772359076292435147ULL, 1787084246871697681ULL,
+    1791104535091311159ULL, 1793376179292590794ULL, 1796401055739264894ULL, 1803524329547304569ULL,
+    1811364963988802845ULL, 1817446867258501821ULL, 1821925532107410018ULL, 1859198800826833019ULL,
+    1860977048510552385ULL, 1861640786947210656ULL, 1861961248290621085ULL, 1863530795531374812ULL,
+    1864855783150927183ULL, 1869738583693256099ULL, 1871513835836861271ULL, 1874721242712405298ULL,
+    1875444173780901845ULL, 1878302332837097370ULL, 1892939947776745274ULL, 1893781383258062886ULL,
+    1895352609470757706ULL, 1910541767234192422ULL, 1913448793166063495ULL, 1913694053215834240ULL,
+    1914549838818690138ULL, 1915405604139242966ULL, 1919567413139019831ULL, 1922250016826038812ULL,
+    1923823301620258715ULL, 1925545021885868317ULL, 1927488754929354254ULL, 1941780671853166417ULL,
+    1947909661863018065ULL, 1949022243059014038ULL, 1950646649348859039ULL, 1953259672333487535ULL,
+    1956136788902479089ULL, 1963295729352672655ULL, 1969788989876581616ULL, 1977331041807788500ULL,
+    1987967201379845746ULL, 1989740580661092619ULL, 1994662439104603339ULL, 1999427603908958997ULL,
+    2000585338349777387ULL, 2001597920280668495ULL, 2006073111411190961ULL, 2019881239444152326ULL,
+    2020425986810808423ULL, 2025356304842089496ULL, 2027739015051640243ULL, 2031106989690815302ULL,
+    2039458766440250333ULL, 2042777305464828156ULL, 2045091706763304856ULL, 2050961644972688921ULL,
+    2057344348130780895ULL, 2058538655277714372ULL, 2059456057742550072ULL, 2063845809519617007ULL,
+    2067373574624714043ULL, 2068215861712106792ULL, 2088899415716318291ULL, 2089067117591372712ULL,
+    2089702922350178016ULL, 2101444693354230663ULL, 2103709528905988268ULL, 2106336494448289650ULL,
+    2106347839488544972ULL, 2106764784008673492ULL, 2120833385069681880ULL, 2121268994436897939ULL,
+    2130157724753862069ULL, 2132153454509663472ULL, 2142318778531506422ULL, 2146467690638419768ULL,
+    2152722344234072671ULL, 2158537039546190675ULL, 2163820706763767766ULL, 2167443421843128361ULL,
+    2172413718748587638ULL, 2174735908722391427ULL, 2177550568339478937ULL, 2194901933251739724ULL,
+    2216383852944386980ULL, 2221519454458365154ULL, 2229325644059912734ULL, 2231438326948672952ULL,
+    2250984766846448676ULL, 2265990671527913121ULL, 2270685403071874371ULL, 2274281164144709600ULL,
+    2303387142953919463ULL, 2329722598665865022ULL, 2368172354875240999ULL, 2371688451595978906ULL,
+    2376114627795047922ULL, 2377164057110059149ULL, 2377439846228999658ULL, 2380304730027672362ULL,
+    2388003358533203347ULL, 2391060187585432802ULL, 2394727550288043490ULL, 2396464357315458611ULL,
+    2411673302365495355ULL, 2421505181125102738ULL, 2421946902695321050ULL, 2422129115551508990ULL,
+    2424344295867624668ULL, 2428397313152691007ULL, 2431275262360082917ULL, 2441922680371356519ULL,
+    2444081266068976624ULL, 2469177384681806957ULL, 2472965670609599284ULL, 2473236106469905191ULL,
+    2475687210660668650ULL, 2485981262020688373ULL, 2491230683580062702ULL, 2494878378841653143ULL,
+    2505513931974261014ULL, 2513147469113320188ULL, 2520533542401678675ULL, 2527060906970620141ULL,
+    2550407249227436784ULL, 2585323501699664720ULL, 2588192066207405689ULL, 2591890856885338427ULL,
+    2597634962348502263ULL, 2599498260882318181ULL, 2607301200877346637ULL, 2616534416887563984ULL,
+    2678505608238579699ULL, 2678722048328224926ULL, 2679912416186706843ULL, 2687655189893069619ULL,
+    2692959609975818960ULL, 2698916899515427978ULL, 2706996203226476859ULL, 2731176567785156878ULL,
+    2733251307866495805ULL, 2734118973793064634ULL, 2734838641991578128ULL, 2739481286332798241ULL,
+    2742811352916401664ULL, 2748238717172906108ULL, 2750443910891037636ULL, 2762309315861662777ULL,
+    2763308216910598304ULL, 2781022904861817317ULL, 2819599975981286912ULL, 2823239220932121865ULL,
+    2837749911824579133ULL, 2846600002561219435ULL, 2859120922079270394ULL, 2877066453796284190ULL,
+    2878760889957605708ULL, 2896391678417689001ULL, 2902771895001447045ULL, 2905234367177824522ULL,
+    2920281920088846093ULL, 2942966587471871991ULL, 2951496650101408213ULL, 2956012247531402637ULL,
+    2970187682225150971ULL, 2987324430255808026ULL, 2987859280367717535ULL, 2988097664992720800ULL,
+    3020296549495555080ULL, 3025763159557198651ULL, 3040271953570120177ULL, 3045566236897031148ULL,
+    3050350417488369827ULL, 3051664883635480387ULL, 3056742967522174713ULL, 3062370580011842999ULL,
+    3071048350188510371ULL, 3076007780922763305ULL, 3087469032846663719ULL, 3091387546790270581ULL,
+    3100074905346191003ULL, 3116551647509615105ULL, 3119392326620238778ULL, 3124534531849345714ULL,
+    3125164648450764474ULL, 3138901386547254404ULL, 3143272189927905287ULL, 3154665819896778871ULL,
+    3169354298454443810ULL, 3178958539909416379ULL, 3190730068949277351ULL, 3193394083785213710ULL,
+    3210542686431954460ULL, 3228947211687485990ULL, 3239526665701019262ULL, 3245564027390491596ULL,
+    3247433362196490891ULL, 3255309790540026847ULL, 3260262780155650750ULL, 3265660074716895343ULL,
+    3297424163079725658ULL, 3300648485863833283ULL, 3311086770369883650ULL, 3332024875236217437ULL,
+    3337967138048646207ULL, 3340265662386450956ULL, 3344103407581775430ULL, 3352065730662268911ULL,
+    3372802259046576235ULL, 3380722058669208335ULL, 3410619434217836716ULL, 3418791933214276410ULL,
+    3424749482649060822ULL, 3436316989159558649ULL, 3444305907984803342ULL, 3458639658792909229ULL,
+    3470108768640756681ULL, 3472766825423608215ULL, 3496053023712937832ULL, 3514951676382178127ULL,
+    3539989201522643321ULL, 3550152038179959247ULL, 3559254190318979746ULL, 3566507867245363721ULL,
+    3618334082804489336ULL, 3619224848083359778ULL, 3626873415009434080ULL, 3633227400090102743ULL,
+    3643333128416791353ULL, 3660051599916952159ULL, 3695856884782793847ULL, 3699175892322234473ULL,
+    3706186635515064210ULL, 3706885753387498964ULL, 3708922783911868056ULL, 3723511959767100476ULL,
+    3729048468500167895ULL, 3739506985376125397ULL, 3765969195245703359ULL, 3769841047613755587ULL,
+    3775255427444122557ULL, 3779146273304888066ULL, 3784798752560061569ULL, 3785524769768461503ULL,
+    3803503227417103938ULL, 3805079877934003377ULL, 3806236092527552446ULL, 3814631670885132484ULL,
+    3818843070250306573ULL, 3822800961410455454ULL, 3834579512305970740ULL, 3859100548906985339ULL,
+    3868428949028401390ULL, 3881095457243360008ULL, 3888192719869867631ULL, 3891891043715315884ULL,
+    3894502336220790152ULL, 3937169696516071585ULL, 3946820749957013601ULL, 3950897491268059259ULL,
+    3959217234244012975ULL, 3971220640958216709ULL, 3974461062746666398ULL, 3999920151214847646ULL,
+    4003038241964342346ULL, 4003995199699560382ULL, 4012797188979142788ULL, 4021214962881648248ULL,
+    4030870889129388066ULL, 4040364483342852722ULL, 4046526515009212852ULL, 4046603498616846791ULL,
+    4063033520544975383ULL, 4066510212897144011ULL, 4077876214148572738ULL, 4089301132147240846ULL,
+    4109699794860968661ULL, 4133518385128946156ULL, 4135123138994404800ULL, 4183236085954648195ULL,
+    4236493218921394822ULL, 4253032710117513550ULL, 4255911676819311063ULL, 4258938948755487038ULL,
+    4264083088519891650ULL, 4267730840572130471ULL, 4274198234382947046ULL, 4276851434916068355ULL,
+    4288165579212902300ULL, 4313541010479701228ULL, 4332262065580830872ULL, 4334813882757064164ULL,
+    4373610599663974825ULL, 4378591439679279253ULL, 4385045463778998504ULL, 4391975225667664073ULL,
+    4393088614348087054ULL, 4414861846848193185ULL, 4449030232274950562ULL, 4468439821353370008ULL,
+    4470979962938139985ULL, 4479638224972504319ULL, 4480554219708951083ULL, 4483881612251357301ULL,
+    4499120444599294590ULL, 4502427796858406283ULL, 4503497560918995418ULL, 4513250681145366402ULL,
+    4516213281720984793ULL, 4556896713386605333ULL, 4583957486506257364ULL, 4594478674728963737ULL,
+    4601870876475228958ULL, 4611786078584114618ULL, 4640642848610053611ULL, 4693810231305768009ULL,
+    4706404842463526052ULL, 4758546732206802605ULL, 4762317513876077078ULL, 4767108526137584770ULL,
+    4773588816312433405ULL, 4776343467579300391ULL, 4826881616666327112ULL, 4843336718356392343ULL,
+    4869254299842780355ULL, 4872624371521616756ULL, 4879302064698680851ULL, 4889061164348967567ULL,
+    4892834029298675275ULL, 4923152292676510042ULL, 4935447075148736176ULL, 4943612932814472246ULL,
+    4944621859171385412ULL, 4964160000476355055ULL, 4970434164285026750ULL, 4978575736783397953ULL,
+    5034749192711155975ULL, 5041749638047249511ULL, 5053122510315447964ULL, 5102246045919760762ULL,
+    5130855811754087424ULL, 5131786393401784636ULL, 5151334041279129387ULL, 5156622277937488177ULL,
+    5173168861266241456ULL, 5221408021931352318ULL, 5270796435214690529ULL, 5282625165520940611ULL,
+    5350556584493132202ULL, 5350602973812495556ULL, 5380188372062224184ULL, 5404208406274161848ULL,
+    5406923849135299607ULL, 5443784465492037156ULL, 5459659072872336658ULL, 5489297416657201268ULL,
+    5490233672658654145ULL, 5502387440223215167ULL, 5529820603000283590ULL, 5619768075260832491ULL,
+    5644822807258558751ULL, 5647240582688447587ULL, 5648222841440292305ULL, 5691576522412835146ULL,
+    5763926102652477766ULL, 5788812684373533561ULL, 5863697079602056564ULL, 5869357921998303480ULL,
+    5875078388615011133ULL, 5892441010441622626ULL, 5994652611242364244ULL, 6112000301877967946ULL,
+    6125237807765586869ULL, 6132456060987582999ULL, 6153203704277570870ULL, 6177930029299708079ULL,
+    6244017917646938181ULL, 6247868029733219299ULL, 6350003718260447388ULL, 6360271830744023004ULL,
+    6389110285740520473ULL, 6389444670661456031ULL, 6507745888159710855ULL, 6610016474418749349ULL,
+    6613874820082531753ULL, 6660311827640770222ULL, 6675796762358534588ULL, 6678070667662095716ULL,
+    6708998999449871842ULL, 6741893936914573306ULL, 6753167103579160803ULL, 6826313258990845862ULL,
+    6905081649114010876ULL, 6919783145100687309ULL, 7061096008444173845ULL, 7129700639722997592ULL,
+    7155599666317932558ULL, 7176428004474108335ULL, 7264244225467541869ULL, 7315038947562822878ULL,
+    7348315960365703688ULL, 7479951600232071884ULL, 7509985002705779123ULL, 7592735099939014468ULL,
+    8086337962984753101ULL, 8722576510951643658ULL, 9287554370207072051ULL, 9288418184024948169ULL,
+    9409628365124333873ULL, 9440180094909644316ULL, 10086532189523737718ULL, 10497238198777750079ULL,
+    10521778522760267701ULL, 11039253632733217376ULL, 11096301452466184797ULL, 11627182107098548031ULL,
+    11743751015148319891ULL, 12015246192683475836ULL, 12913135827833094446ULL, 12986302069752472120ULL,
+    14269646536148038631ULL, 14485888028001949416ULL, 16102450304193906004ULL,
+};
+static const uint16_t bookMoves[BOOK_ENTRIES] = {
+    2060, 7317, 5381, 919, 6657, 4480, 4359, 148, 3716, 2432, 3841, 6793,
+    7318, 80, 3716, 8087, 277, 2443, 4480, 2566, 6040, 7064, 5764, 6040,
+    2191, 7817, 148, 5769, 4740, 6663, 88, 2690, 5127, 4745, 1944, 6538,
+    4743, 1418, 1296, 1810, 1803, 2196, 2068, 918, 647, 4745, 915, 20,
+    4231, 8088, 1541, 2324, 4359, 8087, 5504, 787, 148, 2437, 1944, 4739,
+    4873, 5764, 4239, 2196, 1173, 1809, 6788, 2069, 6168, 6157, 6788, 271,
+    2197, 2196, 785, 2070, 787, 8083, 7251, 3407, 7699, 4740, 7064, 1167,
+    6793, 4866, 5763, 2191, 657, 4872, 7064, 2068, 8088, 7817, 7191, 787,
+    7064, 3718, 5505, 3457, 2432, 4357, 781, 7822, 915, 1424, 915, 1413,
+    5763, 1937, 1103, 2966, 2573, 1173, 4353, 3842, 4485, 7812, 1290, 2197,
+    2196, 7959, 5763, 2196, 2374, 1944, 4611, 1172, 7440, 1167, 2196, 5956,
+    6541, 6669, 7064, 4616, 143, 2966, 4679, 2197, 4740, 7694, 5379, 396,
+    4740, 5764, 920, 143, 4739, 2566, 5138, 910, 5764, 5764, 1546, 1296,
+    5507, 7054, 5764, 3079, 6158, 1418, 4231, 3220, 4480, 1046, 1167, 1418,
+    2443, 5506, 2324, 6533, 3461, 1551, 1813, 7316, 4739, 4612, 1173, 1408,
+    4359, 148, 6167, 6530, 7191, 2963, 6530, 4873, 4364, 5763, 2433, 3329,
+    1551, 3461, 2309, 2689, 4611, 6288, 3461, 3456, 7827, 1365, 6658, 4490,
+    6293, 5705, 4740, 7697, 7816, 6659, 1552, 3591, 7318, 5379, 7190, 5634,
+    5907, 6035, 7313, 3841, 2958, 2314, 4998, 3220, 3220, 5006, 1418, 6040,
+    5636, 3586, 149, 3215, 792, 4613, 6787, 4739, 7812, 2968, 3715, 6659,
+    4357, 16, 4808, 7053, 7317, 5381, 7317, 6531, 2191, 1408, 1108, 1350,
+    2374, 6659, 6931, 3461, 7440, 3220, 787, 1541, 3216, 1408, 150, 977,
+    5769, 2325, 4868, 1237, 7955, 786, 1943, 7812, 920, 2690, 6660, 654,
+    2432, 6798, 394, 2197, 3847, 2196, 920, 3586, 6787, 7064, 4745, 4738,
+    2192, 2432, 659, 1424, 2575, 5769, 2255, 2059, 1360, 394, 6163, 1546,
+    6660, 149, 4745, 3333, 6040, 3461, 7064, 4481, 6793, 3334, 6528, 7447,
+    1103, 2442, 4357, 3210, 4480, 6163, 6925, 6529, 1413, 1300, 2196, 4357,
+    4234, 3655, 919, 2196, 3333, 7822, 1943, 1943, 7693, 2186, 278, 5384,
+    1944, 7687, 2432, 4364, 143, 658, 1813, 659, 1418, 5764, 148, 6284,
+    4357, 4235, 150, 1172, 4739, 654, 642, 4873, 2567, 7314, 2324, 4866,
+    4362, 1044, 3849, 2566, 6167, 792, 5129, 5001, 1408, 389, 7317, 6788,
+    3461, 6544, 2319, 3841, 1109, 1936, 2186, 2960, 1552, 4610, 5005, 4480,
+    4739, 920, 4353, 7059, 792, 5505, 4232, 5764, 5128, 7960, 1173, 6167,
+    6930, 4480, 2968, 6024, 7950, 6787, 4239, 6284, 271, 649, 401, 5137,
+    2432, 4364, 5763, 4480, 2432, 6040, 4868, 6040, 3842, 5763, 2965, 7064,
+    4802, 7316, 5129, 4481, 6025, 1173, 4740, 3456, 4609, 22, 7059, 5635,
+    4873, 4610, 3338, 7059, 277, 6921, 4610, 5506, 389, 3215, 3715, 271,
+    2304, 2304, 4873, 7064, 7187, 6787, 6788, 6530, 2063, 5132, 5010, 4808,
+    6162, 7694, 5764, 1173, 4353, 1173, 4485, 5896, 7817, 3333, 394, 4364,
+    7317, 6040, 5000, 3338, 1808, 1418, 5764, 5507, 272, 5902, 2310, 8087,
+    2314, 6535, 6534, 1813, 6167, 652, 1173, 4362, 1290, 5636, 2196, 5635,
+    4739, 1413, 148, 644, 6528, 8088, 3456, 1231, 4740, 5769, 4883, 5635,
+    4745, 148, 8088, 4363, 6665, 1553, 3851, 5506, 6994, 5506, 4482, 2689,
+    4608, 2432, 5763, 4740, 2433, 6670, 2575, 4482, 4481, 149, 984, 6029,
+    5827, 3456, 5763, 6158, 4232, 5379, 4480, 3215, 6664, 2437, 5634, 1167,
+    4871, 149, 6788, 3586, 2319, 4745, 6035, 4738, 4362, 6530, 8087, 1172,
+    1413, 7064, 5504, 6862, 4614, 7059, 2561, 5897, 2692, 919, 7317, 5133,
+    4740, 3215, 5892, 5128, 1173, 7054, 5507, 268, 150, 87, 4804, 913,
+    8023, 6916, 642, 7191, 4480, 2965, 2437, 4234, 4681, 3393, 6793, 6289,
+    6156, 4480, 3715, 2432, 2438, 5635, 3714, 7128, 4481, 5641, 2442, 2069,
+    8145, 7318, 1809, 6921, 2191, 6294, 6528, 1167, 148, 2437, 6931, 7064,
+    7064, 23, 658, 6040, 4480, 920, 23, 4246, 919, 4808, 6294, 6857,
+    6536, 2571, 2442, 1547, 1418, 3526, 3329, 2196, 4480, 1942, 5504, 4482,
+    5764, 4487, 2442, 7064, 1418, 2432, 3210, 1419, 659, 5133, 5634, 1942,
+    390, 3456, 6921, 4353, 2699, 3088, 7812, 3456, 1365, 7123, 2572, 3585,
+    17, 4357, 7063, 4234, 4807, 4744, 4740, 1942, 2694, 2261, 654, 5379,
+    1811, 1104, 6660, 2069, 7318, 5764, 6162, 6293, 6668, 7054, 1045, 7316,
+    4739, 3714, 1413, 782, 150, 278, 6926, 396, 7955, 3716, 4363, 7059,
+    2560, 4871, 5504, 7827, 6994, 1408, 4739, 2433, 2196, 3329, 3585, 914,
+    7256, 1942, 6167, 1418, 920, 7064, 658, 5507, 6787, 5764, 5005, 5703,
+    4234, 915, 1172, 394, 658, 2314, 5769, 2690, 1413, 6289, 2196, 1803,
+    654, 3716, 647, 2442, 7827, 6035, 2069, 143, 2690, 4358, 3083, 5015,
+    3591, 1944, 2191, 5634, 1300, 5376, 2956, 1296, 4873, 5504, 2324, 6660,
+    6668, 1408, 4480, 5134, 5504, 1167, 4610, 7692, 2689, 7316, 6926, 7812,
+    6534, 6035, 4865, 3713, 8088, 2191, 4740, 5006, 4236, 6546, 5763, 2692,
+    1301, 7817, 6798, 5006, 2379, 2437, 7054, 1937, 266, 2570, 7190, 4866,
+    7812, 1172, 7192, 6156, 6916, 654, 7317, 4485, 1105, 7316, 8083, 1168,
+    7064, 5134, 787, 3585, 6161, 24, 7054, 3461, 4873, 2437, 3847, 3393,
+    6788, 1172, 207, 271, 3591, 2433, 791, 1172, 5384, 2314, 915, 8088,
+    4246, 2314, 4554, 7817, 2197, 4236, 3456, 5902, 6668, 5902, 5965, 1542,
+    2432, 7064, 913, 3461, 5381, 5705, 6916, 5764, 22, 5382, 915, 1551,
+    8082, 3716, 5897, 401, 7316, 920, 3461, 5769, 390, 7059, 6035, 7317,
+    7059, 3206, 2197, 6798, 4485, 4740, 6168, 21, 1104, 3334, 271, 2196,
+    1408, 2433, 2965, 913, 5009, 1943, 271, 2432, 4871, 3715, 3714, 3520,
+    2196, 7314, 3585, 7318, 7812, 1424, 3093, 2432, 7817, 3215, 5774, 3089,
+    4873, 3082, 5383, 6669, 389, 6916, 918, 4745, 1172, 5836, 3715, 1809,
+    5129, 1167, 920, 8088, 1408, 2432, 3715, 6030, 7318, 649, 6155, 2566,
+    7698, 647, 7064, 1290, 2256, 385, 5764, 3461, 4745, 2437, 7064, 4803,
+    2196, 4241, 3461, 2437, 4744, 4873, 1173, 4674, 6035, 5634, 3457, 17,
+    8087, 4244, 1937, 3457, 6035, 150, 6930, 5634, 17, 2060, 6798,
+};
+
+#endif